@@ -0,0 +1,9 @@
+#include <benchmark/benchmark.h>
+
+#include "Function_benchmarks.hpp"
+#include "Function_vector_benchmarks.hpp"
+#include "Task_queue_benchmarks.hpp"
+#include "Timer_wheel_benchmarks.hpp"
+#include "Composition_benchmarks.hpp"
+
+BENCHMARK_MAIN();
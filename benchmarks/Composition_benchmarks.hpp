@@ -0,0 +1,86 @@
+#ifndef ATUL_COMPOSITION_BENCHMARKS
+#define ATUL_COMPOSITION_BENCHMARKS
+
+#include <atul/Composition.hpp>
+#include <atul/Function.hpp>
+
+#include <benchmark/benchmark.h>
+
+namespace atul::benchmarks {
+
+    ///
+    /// One layer of a middleware chain: adjusts the value passed through it
+    /// by an amount captured when the chain is built
+    ///
+    struct Middleware_layer {
+        int adjustment = 0;
+
+        int operator()(int x) const noexcept {
+            return x + adjustment;
+        }
+    };
+
+    ///
+    /// Baseline: each layer is a function wrapper around the wrapper for the
+    /// layers beneath it
+    ///
+    struct Nested_chain_policy {
+        using function_type = SBO_function<16, int(int)>;
+
+        static function_type make(int seed) {
+            function_type chain{Middleware_layer{seed}};
+            for (int i = 1; i < 6; ++i) {
+                chain = function_type{[inner = std::move(chain), layer = Middleware_layer{seed + i}] (int x) mutable {
+                    return layer(inner(x));
+                }};
+            }
+
+            return chain;
+        }
+    };
+
+    ///
+    /// All layers composed into one callable held by one wrapper
+    ///
+    struct Composed_chain_policy {
+        using function_type = SBO_function<16, int(int)>;
+
+        static function_type make(int seed) {
+            return function_type{atul::compose(
+                Middleware_layer{seed + 5},
+                Middleware_layer{seed + 4},
+                Middleware_layer{seed + 3},
+                Middleware_layer{seed + 2},
+                Middleware_layer{seed + 1},
+                Middleware_layer{seed}
+            )};
+        }
+    };
+
+    template<class Policy>
+    void BM_chain_build(benchmark::State& state) {
+        int seed = 0;
+        for (auto _ : state) {
+            auto chain = Policy::make(++seed);
+            benchmark::DoNotOptimize(chain);
+        }
+    }
+
+    template<class Policy>
+    void BM_chain_invoke(benchmark::State& state) {
+        auto chain = Policy::make(1);
+        int x = 0;
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(x = chain(x) & 0xff);
+        }
+    }
+
+    BENCHMARK_TEMPLATE(BM_chain_build, Nested_chain_policy);
+    BENCHMARK_TEMPLATE(BM_chain_build, Composed_chain_policy);
+
+    BENCHMARK_TEMPLATE(BM_chain_invoke, Nested_chain_policy);
+    BENCHMARK_TEMPLATE(BM_chain_invoke, Composed_chain_policy);
+
+}
+
+#endif
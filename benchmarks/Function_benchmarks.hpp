@@ -0,0 +1,328 @@
+#ifndef ATUL_FUNCTION_BENCHMARKS
+#define ATUL_FUNCTION_BENCHMARKS
+
+#include <atul/Function.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <memory_resource>
+#include <functional>
+#include <chrono>
+#include <array>
+#include <cstdint>
+
+namespace atul::benchmarks {
+
+    //=====================================================
+    // Callables
+    //=====================================================
+
+    ///
+    /// Functor whose size matches the size of the capture it simulates.
+    ///
+    template<std::size_t N>
+    struct Payload_functor {
+        std::array<std::uint8_t, N> payload{};
+
+        int operator()(int x) noexcept {
+            return x + payload[0];
+        }
+    };
+
+    static_assert(sizeof(Payload_functor<8>) == 8);
+    static_assert(sizeof(Payload_functor<256>) == 256);
+
+    int free_function(int x) {
+        return x + 1;
+    }
+
+    //=====================================================
+    // Wrapper policies
+    //=====================================================
+
+    struct Function_pointer_policy {
+        using function_type = int (*)(int);
+
+        template<class F>
+        function_type make(F&&) {
+            return &free_function;
+        }
+
+        void recycle() {}
+    };
+
+    struct Std_function_policy {
+        using function_type = std::function<int(int)>;
+
+        template<class F>
+        function_type make(F&& f) {
+            return function_type{std::forward<F>(f)};
+        }
+
+        void recycle() {}
+    };
+
+    struct Function_policy {
+        using function_type = Function<int(int)>;
+
+        template<class F>
+        function_type make(F&& f) {
+            return function_type{std::forward<F>(f)};
+        }
+
+        void recycle() {}
+    };
+
+    template<std::size_t SB_size, class C = int(int)>
+    struct SBO_function_policy {
+        using function_type = SBO_function<SB_size, C>;
+
+        template<class F>
+        function_type make(F&& f) {
+            return function_type{std::forward<F>(f)};
+        }
+
+        void recycle() {}
+    };
+
+    struct Pool_resource_policy {
+        using function_type = AA_function<std::pmr::polymorphic_allocator<std::byte>, int(int)>;
+
+        std::pmr::unsynchronized_pool_resource resource;
+
+        template<class F>
+        function_type make(F&& f) {
+            return function_type{&resource, std::forward<F>(f)};
+        }
+
+        void recycle() {}
+    };
+
+    struct Pool_allocator_policy {
+        using function_type = AA_function<Pool_allocator<std::byte, int(int)>, int(int)>;
+
+        template<class F>
+        function_type make(F&& f) {
+            return function_type{std::forward<F>(f)};
+        }
+
+        void recycle() {}
+    };
+
+    struct Monotonic_resource_policy {
+        using function_type = AA_function<std::pmr::polymorphic_allocator<std::byte>, int(int)>;
+
+        std::pmr::monotonic_buffer_resource resource;
+
+        template<class F>
+        function_type make(F&& f) {
+            return function_type{&resource, std::forward<F>(f)};
+        }
+
+        void recycle() {
+            resource.release();
+        }
+    };
+
+    //=====================================================
+    // Benchmark helpers
+    //=====================================================
+
+    ///
+    /// Number of objects operated on per iteration of the lifetime
+    /// benchmarks. The per_op counter reports the time per object.
+    ///
+    constexpr std::size_t batch_size = 64;
+
+    using benchmark_clock = std::chrono::steady_clock;
+
+    template<class T>
+    struct Batch {
+        alignas(T) std::byte storage[batch_size * sizeof(T)];
+
+        T& operator[](std::size_t i) {
+            return reinterpret_cast<T*>(storage)[i];
+        }
+
+        void destroy() {
+            for (std::size_t i = 0; i < batch_size; ++i) {
+                (*this)[i].~T();
+            }
+        }
+    };
+
+    template<class F>
+    double time_of(F&& f) {
+        auto t0 = benchmark_clock::now();
+        f();
+        auto t1 = benchmark_clock::now();
+        return std::chrono::duration<double>(t1 - t0).count();
+    }
+
+    void set_per_op_counter(benchmark::State& state) {
+        state.counters["per_op"] = benchmark::Counter(
+            static_cast<double>(batch_size),
+            benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert
+        );
+    }
+
+    //=====================================================
+    // Benchmarks
+    //=====================================================
+
+    template<class Policy, std::size_t N>
+    void BM_construct(benchmark::State& state) {
+        using function_type = typename Policy::function_type;
+
+        Policy policy;
+        Payload_functor<N> functor{};
+        Batch<function_type> batch;
+
+        for (auto _ : state) {
+            state.SetIterationTime(time_of([&] () {
+                for (std::size_t i = 0; i < batch_size; ++i) {
+                    new (&batch[i]) function_type{policy.make(functor)};
+                }
+                benchmark::ClobberMemory();
+            }));
+
+            batch.destroy();
+            policy.recycle();
+        }
+
+        set_per_op_counter(state);
+    }
+
+    template<class Policy, std::size_t N>
+    void BM_destroy(benchmark::State& state) {
+        using function_type = typename Policy::function_type;
+
+        Policy policy;
+        Payload_functor<N> functor{};
+        Batch<function_type> batch;
+
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < batch_size; ++i) {
+                new (&batch[i]) function_type{policy.make(functor)};
+            }
+
+            state.SetIterationTime(time_of([&] () {
+                batch.destroy();
+                benchmark::ClobberMemory();
+            }));
+
+            policy.recycle();
+        }
+
+        set_per_op_counter(state);
+    }
+
+    template<class Policy, std::size_t N>
+    void BM_copy(benchmark::State& state) {
+        using function_type = typename Policy::function_type;
+
+        Policy policy;
+        Batch<function_type> batch;
+
+        for (auto _ : state) {
+            {
+                function_type source = policy.make(Payload_functor<N>{});
+
+                state.SetIterationTime(time_of([&] () {
+                    for (std::size_t i = 0; i < batch_size; ++i) {
+                        new (&batch[i]) function_type{source};
+                    }
+                    benchmark::ClobberMemory();
+                }));
+
+                batch.destroy();
+            }
+            policy.recycle();
+        }
+
+        set_per_op_counter(state);
+    }
+
+    template<class Policy, std::size_t N>
+    void BM_move(benchmark::State& state) {
+        using function_type = typename Policy::function_type;
+
+        Policy policy;
+        Payload_functor<N> functor{};
+        Batch<function_type> sources;
+        Batch<function_type> batch;
+
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < batch_size; ++i) {
+                new (&sources[i]) function_type{policy.make(functor)};
+            }
+
+            state.SetIterationTime(time_of([&] () {
+                for (std::size_t i = 0; i < batch_size; ++i) {
+                    new (&batch[i]) function_type{std::move(sources[i])};
+                }
+                benchmark::ClobberMemory();
+            }));
+
+            batch.destroy();
+            sources.destroy();
+            policy.recycle();
+        }
+
+        set_per_op_counter(state);
+    }
+
+    template<class Policy, std::size_t N>
+    void BM_invoke(benchmark::State& state) {
+        Policy policy;
+        auto function = policy.make(Payload_functor<N>{});
+
+        int x = 0;
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(function);
+            // The int travels to the callable in a register, as it would
+            // through a plain function pointer, rather than via a reference
+            x = function(x);
+            benchmark::DoNotOptimize(x);
+        }
+    }
+
+    //=====================================================
+    // Registration
+    //=====================================================
+
+    #define ATUL_DEFINE_FUNCTION_BENCHMARK(policy, n) \
+        BENCHMARK_TEMPLATE(BM_construct, policy, n)->UseManualTime(); \
+        BENCHMARK_TEMPLATE(BM_destroy, policy, n)->UseManualTime(); \
+        BENCHMARK_TEMPLATE(BM_copy, policy, n)->UseManualTime(); \
+        BENCHMARK_TEMPLATE(BM_move, policy, n)->UseManualTime(); \
+        BENCHMARK_TEMPLATE(BM_invoke, policy, n)
+
+    #define ATUL_DEFINE_FUNCTION_BENCHMARKS(policy) \
+        ATUL_DEFINE_FUNCTION_BENCHMARK(policy, 8); \
+        ATUL_DEFINE_FUNCTION_BENCHMARK(policy, 24); \
+        ATUL_DEFINE_FUNCTION_BENCHMARK(policy, 64); \
+        ATUL_DEFINE_FUNCTION_BENCHMARK(policy, 256)
+
+    // Function pointers carry no capture so a single size suffices
+    ATUL_DEFINE_FUNCTION_BENCHMARK(Function_pointer_policy, 8);
+
+    ATUL_DEFINE_FUNCTION_BENCHMARKS(Std_function_policy);
+    ATUL_DEFINE_FUNCTION_BENCHMARKS(Function_policy);
+    ATUL_DEFINE_FUNCTION_BENCHMARKS(SBO_function_policy<16>);
+    ATUL_DEFINE_FUNCTION_BENCHMARKS(SBO_function_policy<32>);
+    ATUL_DEFINE_FUNCTION_BENCHMARKS(SBO_function_policy<64>);
+    ATUL_DEFINE_FUNCTION_BENCHMARKS(SBO_function_policy<256>);
+    ATUL_DEFINE_FUNCTION_BENCHMARKS(Pool_resource_policy);
+    ATUL_DEFINE_FUNCTION_BENCHMARKS(Monotonic_resource_policy);
+    ATUL_DEFINE_FUNCTION_BENCHMARKS(Pool_allocator_policy);
+
+    // A noexcept signature drops the empty check and the exception edge
+    BENCHMARK_TEMPLATE(BM_invoke, SBO_function_policy<32, int(int) noexcept>, 8);
+
+    #undef ATUL_DEFINE_FUNCTION_BENCHMARKS
+    #undef ATUL_DEFINE_FUNCTION_BENCHMARK
+
+}
+
+#endif
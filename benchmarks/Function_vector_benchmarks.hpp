@@ -0,0 +1,73 @@
+#ifndef ATUL_FUNCTION_VECTOR_BENCHMARKS
+#define ATUL_FUNCTION_VECTOR_BENCHMARKS
+
+#include <atul/Function_vector.hpp>
+#include <atul/Function.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <functional>
+#include <vector>
+
+namespace atul::benchmarks {
+
+    ///
+    /// Listener types used to populate the fan-out benchmarks. Listeners are
+    /// mostly of the first type, with every sixteenth of another type.
+    ///
+    template<int K>
+    struct Listener {
+        int* total;
+
+        void operator()(int x) {
+            *total += x + K;
+        }
+    };
+
+    template<class Add>
+    void populate_listeners(Add add, int* total, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            switch (i % 16) {
+            case 5: add(Listener<1>{total}); break;
+            case 11: add(Listener<2>{total}); break;
+            default: add(Listener<0>{total}); break;
+            }
+        }
+    }
+
+    template<class F>
+    void BM_fan_out_vector(benchmark::State& state) {
+        int total = 0;
+        std::vector<F> listeners;
+        populate_listeners([&] (auto l) { listeners.emplace_back(l); }, &total, static_cast<std::size_t>(state.range(0)));
+
+        for (auto _ : state) {
+            for (auto& listener : listeners) {
+                listener(1);
+            }
+            benchmark::DoNotOptimize(total);
+        }
+
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void BM_fan_out_function_vector(benchmark::State& state) {
+        int total = 0;
+        Function_vector<void(int)> listeners;
+        populate_listeners([&] (auto l) { listeners.push_back(l); }, &total, static_cast<std::size_t>(state.range(0)));
+
+        for (auto _ : state) {
+            listeners.invoke_all(1);
+            benchmark::DoNotOptimize(total);
+        }
+
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    BENCHMARK_TEMPLATE(BM_fan_out_vector, std::function<void(int)>)->Arg(10000);
+    BENCHMARK_TEMPLATE(BM_fan_out_vector, SBO_function<16, void(int)>)->Arg(10000);
+    BENCHMARK(BM_fan_out_function_vector)->Arg(10000);
+
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef ATUL_TASK_QUEUE_BENCHMARKS
+#define ATUL_TASK_QUEUE_BENCHMARKS
+
+#include <atul/Task_queue.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace atul::benchmarks {
+
+    ///
+    /// Baseline: a mutex-protected std::deque of std::function, as used by
+    /// typical hand-rolled work queues
+    ///
+    class Locked_std_function_queue {
+    public:
+
+        explicit Locked_std_function_queue(std::size_t) {}
+
+        template<class C>
+        bool try_push(C&& c) {
+            std::lock_guard<std::mutex> lock{mutex};
+            tasks.emplace_back(std::forward<C>(c));
+            return true;
+        }
+
+        bool try_pop_invoke() {
+            std::function<void()> task;
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                if (tasks.empty()) {
+                    return false;
+                }
+
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+
+            task();
+            return true;
+        }
+
+    private:
+
+        std::mutex mutex;
+
+        std::deque<std::function<void()>> tasks;
+
+    };
+
+    ///
+    /// Each thread repeatedly pushes a task carrying a 32 byte capture and
+    /// then pops and runs one task, which may have been pushed by any
+    /// thread.
+    ///
+    template<class Queue>
+    void BM_task_queue_round_trip(benchmark::State& state) {
+        static Queue* queue = nullptr;
+        static std::atomic<long> total{0};
+
+        if (state.thread_index() == 0) {
+            queue = new Queue{1024};
+        }
+
+        std::array<long, 4> capture{1, 2, 3, 4};
+        for (auto _ : state) {
+            while (!queue->try_push([capture] () { total.fetch_add(capture[0], std::memory_order_relaxed); })) {
+                std::this_thread::yield();
+            }
+
+            while (!queue->try_pop_invoke()) {
+                std::this_thread::yield();
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations());
+
+        if (state.thread_index() == 0) {
+            delete queue;
+        }
+    }
+
+    BENCHMARK_TEMPLATE(BM_task_queue_round_trip, Locked_std_function_queue)->ThreadRange(1, 8)->UseRealTime();
+    BENCHMARK_TEMPLATE(BM_task_queue_round_trip, Task_queue<void()>)->ThreadRange(1, 8)->UseRealTime();
+
+}
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef ATUL_TIMER_WHEEL_BENCHMARKS
+#define ATUL_TIMER_WHEEL_BENCHMARKS
+
+#include <atul/Timer_wheel.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace atul::benchmarks {
+
+    ///
+    /// Baseline: an ordered multimap from deadline to std::function
+    ///
+    class Multimap_timers {
+    public:
+
+        using time_type = std::uint64_t;
+
+        using id_type = std::multimap<time_type, std::function<void()>>::iterator;
+
+        template<class C>
+        id_type schedule(time_type deadline, C&& c) {
+            return timers.emplace(deadline, std::forward<C>(c));
+        }
+
+        void cancel(id_type id) {
+            timers.erase(id);
+        }
+
+        std::size_t advance(time_type now) {
+            std::size_t fired = 0;
+            while (!timers.empty() && timers.begin()->first <= now) {
+                auto node = timers.extract(timers.begin());
+                node.mapped()();
+                ++fired;
+            }
+
+            return fired;
+        }
+
+    private:
+
+        std::multimap<time_type, std::function<void()>> timers;
+
+    };
+
+    class Wheel_timers {
+    public:
+
+        using time_type = Timer_wheel::time_type;
+
+        using id_type = Timer_id;
+
+        template<class C>
+        id_type schedule(time_type deadline, C&& c) {
+            return wheel.schedule(deadline, std::forward<C>(c));
+        }
+
+        void cancel(id_type id) {
+            wheel.cancel(id);
+        }
+
+        std::size_t advance(time_type now) {
+            return wheel.advance(now);
+        }
+
+    private:
+
+        Timer_wheel wheel;
+
+    };
+
+    ///
+    /// Connection timeouts: with state.range(0) timers outstanding, each
+    /// iteration schedules a timer carrying a 32 byte capture and cancels
+    /// the oldest one, as when a connection's timeout is pushed back on
+    /// activity
+    ///
+    template<class Timers>
+    void BM_timer_schedule_cancel(benchmark::State& state) {
+        const auto outstanding = static_cast<std::size_t>(state.range(0));
+
+        Timers timers;
+        std::mt19937_64 engine{1};
+        std::array<std::uint64_t, 4> capture{};
+        long sink = 0;
+
+        std::vector<typename Timers::id_type> ids;
+        for (std::size_t i = 0; i < outstanding; ++i) {
+            ids.push_back(timers.schedule(1 + engine() % 100000, [&sink, capture] () { sink += capture[0]; }));
+        }
+
+        std::size_t oldest = 0;
+        for (auto _ : state) {
+            timers.cancel(ids[oldest]);
+            ids[oldest] = timers.schedule(1 + engine() % 100000, [&sink, capture] () { sink += capture[0]; });
+            oldest = (oldest + 1) % outstanding;
+        }
+
+        benchmark::DoNotOptimize(sink);
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    ///
+    /// Expiry: each iteration schedules a batch of timers over the next 1024
+    /// ticks and advances time until all of them have fired
+    ///
+    template<class Timers>
+    void BM_timer_expiry(benchmark::State& state) {
+        const auto batch = static_cast<std::size_t>(state.range(0));
+
+        Timers timers;
+        std::mt19937_64 engine{1};
+        std::array<std::uint64_t, 4> capture{1, 2, 3, 4};
+        long sink = 0;
+
+        std::uint64_t now = 0;
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < batch; ++i) {
+                timers.schedule(now + 1 + engine() % 1024, [&sink, capture] () { sink += capture[0]; });
+            }
+
+            for (std::uint64_t step = 0; step < 1024; step += 16) {
+                now += 16;
+                timers.advance(now);
+            }
+        }
+
+        benchmark::DoNotOptimize(sink);
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(batch));
+    }
+
+    BENCHMARK_TEMPLATE(BM_timer_schedule_cancel, Multimap_timers)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+    BENCHMARK_TEMPLATE(BM_timer_schedule_cancel, Wheel_timers)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+    BENCHMARK_TEMPLATE(BM_timer_expiry, Multimap_timers)->Arg(1 << 10)->Arg(1 << 14);
+    BENCHMARK_TEMPLATE(BM_timer_expiry, Wheel_timers)->Arg(1 << 10)->Arg(1 << 14);
+
+}
+
+#endif
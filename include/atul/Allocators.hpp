@@ -0,0 +1,545 @@
+#ifndef ATUL_ALLOCATORS_HPP
+#define ATUL_ALLOCATORS_HPP
+
+#include <memory_resource>
+#include <type_traits>
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <new>
+#include <cstddef>
+
+namespace atul {
+
+    //=====================================================
+    // Allocator traits
+    //=====================================================
+
+    ///
+    /// Trait indicating whether calls to an allocator's deallocate function
+    /// have no effect, in which case they may be skipped entirely.
+    ///
+    /// Allocators advertise this by defining a nested is_deallocation_noop
+    /// type alias to std::true_type. The trait may also be specialized.
+    ///
+    /// @tparam A STL compatible allocator type
+    template<class A, class = void>
+    struct is_deallocation_noop : std::false_type {};
+
+    template<class A>
+    struct is_deallocation_noop<A, std::void_t<typename A::is_deallocation_noop>> : A::is_deallocation_noop {};
+
+    template<class A>
+    inline constexpr bool is_deallocation_noop_v = is_deallocation_noop<A>::value;
+
+    //=====================================================
+    // Allocator_pair
+    //=====================================================
+
+    ///
+    /// Stores an allocator alongside a value of another type. Allocators of
+    /// empty class type take up no space, by way of the empty base
+    /// optimization.
+    ///
+    /// Containing the allocator in a member of this type, rather than
+    /// inheriting from it, keeps the allocator's member names out of the
+    /// containing class.
+    ///
+    /// @tparam A STL compatible allocator type
+    /// @tparam T Type of value stored alongside the allocator
+    template<class A, class T, bool = std::is_empty_v<A> && !std::is_final_v<A>>
+    class Allocator_pair : private A {
+    public:
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        Allocator_pair() = default;
+
+        Allocator_pair(const A& a, const T& value):
+            A(a),
+            stored_value(value) {}
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        [[nodiscard]]
+        A& allocator() noexcept {
+            return *this;
+        }
+
+        [[nodiscard]]
+        const A& allocator() const noexcept {
+            return *this;
+        }
+
+        [[nodiscard]]
+        T& value() noexcept {
+            return stored_value;
+        }
+
+        [[nodiscard]]
+        const T& value() const noexcept {
+            return stored_value;
+        }
+
+    private:
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        T stored_value{};
+
+    };
+
+    template<class A, class T>
+    class Allocator_pair<A, T, false> {
+    public:
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        Allocator_pair() = default;
+
+        Allocator_pair(const A& a, const T& value):
+            stored_allocator(a),
+            stored_value(value) {}
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        [[nodiscard]]
+        A& allocator() noexcept {
+            return stored_allocator;
+        }
+
+        [[nodiscard]]
+        const A& allocator() const noexcept {
+            return stored_allocator;
+        }
+
+        [[nodiscard]]
+        T& value() noexcept {
+            return stored_value;
+        }
+
+        [[nodiscard]]
+        const T& value() const noexcept {
+            return stored_value;
+        }
+
+    private:
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        A stored_allocator{};
+
+        T stored_value{};
+
+    };
+
+    //=====================================================
+    // Arena_allocator
+    //=====================================================
+
+    ///
+    /// STL compatible allocator which obtains memory from a
+    /// std::pmr::monotonic_buffer_resource.
+    ///
+    /// Deallocation is a no-op. Memory is only reclaimed in bulk when the
+    /// underlying resource is released or destroyed, which makes this
+    /// allocator suitable for objects whose lifetimes are bounded by a single
+    /// request or frame. Containers of Arena_allocator skip deallocation
+    /// calls entirely.
+    ///
+    /// @tparam T Allocated type
+    template<class T>
+    class Arena_allocator {
+    public:
+
+        //=================================================
+        // Type aliases
+        //=================================================
+
+        using value_type = T;
+
+        using is_deallocation_noop = std::true_type;
+
+        using is_always_equal = std::false_type;
+
+        using propagate_on_container_copy_assignment = std::true_type;
+
+        using propagate_on_container_move_assignment = std::true_type;
+
+        using propagate_on_container_swap = std::true_type;
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        explicit Arena_allocator(std::pmr::monotonic_buffer_resource& resource) noexcept:
+            resource(&resource) {}
+
+        Arena_allocator(const Arena_allocator&) noexcept = default;
+
+        template<class U>
+        Arena_allocator(const Arena_allocator<U>& other) noexcept:
+            resource(other.resource) {}
+
+        //=================================================
+        // Assignment operators
+        //=================================================
+
+        Arena_allocator& operator=(const Arena_allocator&) noexcept = default;
+
+        //=================================================
+        // Comparison operators
+        //=================================================
+
+        template<class U>
+        [[nodiscard]]
+        bool operator==(const Arena_allocator<U>& rhs) const noexcept {
+            return resource == rhs.resource;
+        }
+
+        template<class U>
+        [[nodiscard]]
+        bool operator!=(const Arena_allocator<U>& rhs) const noexcept {
+            return resource != rhs.resource;
+        }
+
+        //=================================================
+        // Allocation methods
+        //=================================================
+
+        [[nodiscard]]
+        T* allocate(std::size_t n) {
+            return static_cast<T*>(resource->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T*, std::size_t) noexcept {}
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        [[nodiscard]]
+        std::pmr::monotonic_buffer_resource* arena() const noexcept {
+            return resource;
+        }
+
+    private:
+
+        template<class U>
+        friend class Arena_allocator;
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        std::pmr::monotonic_buffer_resource* resource;
+
+    };
+
+    //=====================================================
+    // Block_pool
+    //=====================================================
+
+    ///
+    /// Process-wide pool of fixed-size memory blocks, segregated into size
+    /// classes which are multiples of 16 bytes up to 256 bytes.
+    ///
+    /// Each thread keeps its own free list per size class and exchanges
+    /// blocks with a shared, mutex-protected free list in batches, so the
+    /// common case of allocation and deallocation takes no lock. Requests
+    /// which are larger or more aligned than the largest size class are
+    /// forwarded to the global operator new.
+    ///
+    /// Once a thread's cache has been destroyed, blocks allocated or
+    /// deallocated by that thread's remaining thread_local objects go
+    /// directly through the shared free list.
+    ///
+    /// Memory obtained by the pool is never returned to the system.
+    ///
+    /// @tparam Tag Type distinguishing independent pools
+    template<class Tag>
+    class Block_pool {
+    public:
+
+        //=================================================
+        // Constants
+        //=================================================
+
+        static constexpr std::size_t block_alignment = 16;
+
+        static constexpr std::size_t size_class_count = 16;
+
+        static constexpr std::size_t max_block_size = block_alignment * size_class_count;
+
+        ///
+        /// Number of blocks exchanged with the shared pool at once
+        ///
+        static constexpr std::size_t batch_size = 32;
+
+        ///
+        /// Number of blocks carved out of a chunk when the shared pool runs
+        /// out
+        ///
+        static constexpr std::size_t blocks_per_chunk = 4 * batch_size;
+
+        //=================================================
+        // Allocation methods
+        //=================================================
+
+        [[nodiscard]]
+        static void* allocate(std::size_t bytes, std::size_t alignment) {
+            if (bytes > max_block_size || alignment > block_alignment) {
+                return ::operator new(bytes, std::align_val_t{std::max(alignment, block_alignment)});
+            }
+
+            if (local_cache_destroyed()) {
+                Free_list list{};
+                shared_pool().refill(list, size_class(bytes));
+                void* p = list.pop();
+                shared_pool().drain(list, size_class(bytes), list.count);
+                return p;
+            }
+
+            Free_list& list = local_cache().lists[size_class(bytes)];
+            if (!list.head) {
+                shared_pool().refill(list, size_class(bytes));
+            }
+
+            return list.pop();
+        }
+
+        static void deallocate(void* p, std::size_t bytes, std::size_t alignment) noexcept {
+            if (bytes > max_block_size || alignment > block_alignment) {
+                ::operator delete(p, std::align_val_t{std::max(alignment, block_alignment)});
+                return;
+            }
+
+            if (local_cache_destroyed()) {
+                Free_list list{};
+                list.push(p);
+                shared_pool().drain(list, size_class(bytes), 1);
+                return;
+            }
+
+            Free_list& list = local_cache().lists[size_class(bytes)];
+            list.push(p);
+            if (list.count >= 2 * batch_size) {
+                shared_pool().drain(list, size_class(bytes), batch_size);
+            }
+        }
+
+    private:
+
+        //=================================================
+        // Helper classes
+        //=================================================
+
+        struct Free_block {
+            Free_block* next;
+        };
+
+        struct Free_list {
+            Free_block* head = nullptr;
+
+            std::size_t count = 0;
+
+            void push(void* p) noexcept {
+                auto* block = static_cast<Free_block*>(p);
+                block->next = head;
+                head = block;
+                ++count;
+            }
+
+            [[nodiscard]]
+            void* pop() noexcept {
+                Free_block* block = head;
+                head = block->next;
+                --count;
+                return block;
+            }
+        };
+
+        struct Shared_pool {
+            std::mutex mutex;
+
+            std::array<Free_list, size_class_count> lists{};
+
+            ///
+            /// Moves up to batch_size blocks into local, allocating a new
+            /// chunk if none are available
+            ///
+            void refill(Free_list& local, std::size_t size_class) {
+                std::lock_guard<std::mutex> lock{mutex};
+
+                Free_list& shared = lists[size_class];
+                if (!shared.head) {
+                    const std::size_t block_size = (size_class + 1) * block_alignment;
+                    auto* chunk = static_cast<std::byte*>(::operator new(
+                        block_size * blocks_per_chunk,
+                        std::align_val_t{block_alignment}
+                    ));
+
+                    for (std::size_t i = blocks_per_chunk; i-- > 0;) {
+                        shared.push(chunk + i * block_size);
+                    }
+                }
+
+                for (std::size_t i = 0; i < batch_size && shared.head; ++i) {
+                    local.push(shared.pop());
+                }
+            }
+
+            ///
+            /// Moves up to n blocks from local back into the shared pool
+            ///
+            void drain(Free_list& local, std::size_t size_class, std::size_t n) noexcept {
+                std::lock_guard<std::mutex> lock{mutex};
+
+                Free_list& shared = lists[size_class];
+                for (std::size_t i = 0; i < n && local.head; ++i) {
+                    shared.push(local.pop());
+                }
+            }
+        };
+
+        struct Local_cache {
+            std::array<Free_list, size_class_count> lists{};
+
+            ~Local_cache() {
+                local_cache_destroyed() = true;
+                for (std::size_t i = 0; i < size_class_count; ++i) {
+                    shared_pool().drain(lists[i], i, lists[i].count);
+                }
+            }
+        };
+
+        //=================================================
+        // Helper functions
+        //=================================================
+
+        [[nodiscard]]
+        static constexpr std::size_t size_class(std::size_t bytes) noexcept {
+            return (std::max(bytes, std::size_t{1}) - 1) / block_alignment;
+        }
+
+        [[nodiscard]]
+        static Shared_pool& shared_pool() {
+            // Intentionally leaked so that it outlives all thread-local caches
+            // and any function objects with static storage duration
+            static Shared_pool* pool = new Shared_pool{};
+            return *pool;
+        }
+
+        [[nodiscard]]
+        static Local_cache& local_cache() {
+            thread_local Local_cache cache{};
+            return cache;
+        }
+
+        ///
+        /// Set once the calling thread's cache has been destroyed. Trivially
+        /// destructible, so it remains usable by thread_local objects which
+        /// are destroyed after the cache.
+        ///
+        [[nodiscard]]
+        static bool& local_cache_destroyed() noexcept {
+            thread_local bool destroyed = false;
+            return destroyed;
+        }
+
+    };
+
+    //=====================================================
+    // Pool_allocator
+    //=====================================================
+
+    ///
+    /// Stateless STL compatible allocator backed by a Block_pool.
+    ///
+    /// Well suited to the fixed-size blocks requested by AA_SBO_function for
+    /// Callable_wrapper objects. Using a distinct Tag, such as the function
+    /// signature, for each kind of wrapper keeps their blocks in separate
+    /// pools.
+    ///
+    /// @tparam T Allocated type
+    /// @tparam Tag Type selecting the underlying Block_pool
+    template<class T, class Tag = void>
+    class Pool_allocator {
+    public:
+
+        //=================================================
+        // Type aliases
+        //=================================================
+
+        using value_type = T;
+
+        using is_always_equal = std::true_type;
+
+        template<class U>
+        struct rebind {
+            using other = Pool_allocator<U, Tag>;
+        };
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        Pool_allocator() noexcept = default;
+
+        Pool_allocator(const Pool_allocator&) noexcept = default;
+
+        template<class U>
+        Pool_allocator(const Pool_allocator<U, Tag>&) noexcept {}
+
+        //=================================================
+        // Assignment operators
+        //=================================================
+
+        Pool_allocator& operator=(const Pool_allocator&) noexcept = default;
+
+        //=================================================
+        // Comparison operators
+        //=================================================
+
+        template<class U>
+        [[nodiscard]]
+        bool operator==(const Pool_allocator<U, Tag>&) const noexcept {
+            return true;
+        }
+
+        template<class U>
+        [[nodiscard]]
+        bool operator!=(const Pool_allocator<U, Tag>&) const noexcept {
+            return false;
+        }
+
+        //=================================================
+        // Allocation methods
+        //=================================================
+
+        [[nodiscard]]
+        T* allocate(std::size_t n) {
+            return static_cast<T*>(Block_pool<Tag>::allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept {
+            Block_pool<Tag>::deallocate(p, n * sizeof(T), alignof(T));
+        }
+
+    };
+
+}
+
+#endif //ATUL_ALLOCATORS_HPP
@@ -0,0 +1,435 @@
+#ifndef ATUL_COMPOSITION_HPP
+#define ATUL_COMPOSITION_HPP
+
+#include "Relocation.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace atul {
+
+    //=====================================================
+    // Type lists
+    //=====================================================
+
+    template<class...Ts>
+    struct Type_list {};
+
+    template<std::size_t I, class List>
+    struct Type_list_element;
+
+    template<class T, class...Ts>
+    struct Type_list_element<0, Type_list<T, Ts...>> {
+        using type = T;
+    };
+
+    template<std::size_t I, class T, class...Ts>
+    struct Type_list_element<I, Type_list<T, Ts...>> : Type_list_element<I - 1, Type_list<Ts...>> {};
+
+    template<std::size_t I, class List>
+    using type_list_element_t = typename Type_list_element<I, List>::type;
+
+    //=====================================================
+    // Callable_pack
+    //=====================================================
+
+    ///
+    /// Holds one callable of a Callable_pack. Empty callables are held as a
+    /// base class so that they take up no space.
+    ///
+    template<std::size_t I, class T, bool = std::is_empty_v<T> && !std::is_final_v<T>>
+    class Callable_pack_element : private T {
+    public:
+
+        template<class U>
+        explicit Callable_pack_element(U&& u):
+            T(std::forward<U>(u)) {}
+
+        [[nodiscard]]
+        T& get() noexcept {
+            return *this;
+        }
+
+        [[nodiscard]]
+        const T& get() const noexcept {
+            return *this;
+        }
+
+    };
+
+    template<std::size_t I, class T>
+    class Callable_pack_element<I, T, false> {
+    public:
+
+        template<class U>
+        explicit Callable_pack_element(U&& u):
+            value(std::forward<U>(u)) {}
+
+        [[nodiscard]]
+        T& get() noexcept {
+            return value;
+        }
+
+        [[nodiscard]]
+        const T& get() const noexcept {
+            return value;
+        }
+
+    private:
+
+        T value;
+
+    };
+
+    template<class Indices, class...Ts>
+    class Callable_pack_base;
+
+    template<std::size_t...Is, class...Ts>
+    class Callable_pack_base<std::index_sequence<Is...>, Ts...> : public Callable_pack_element<Is, Ts>... {
+    public:
+
+        template<class...Us>
+        explicit Callable_pack_base(std::in_place_t, Us&&...us):
+            Callable_pack_element<Is, Ts>(std::forward<Us>(us))... {}
+
+        template<std::size_t I>
+        [[nodiscard]]
+        auto& get() & noexcept {
+            return static_cast<element_type<I>&>(*this).get();
+        }
+
+        template<std::size_t I>
+        [[nodiscard]]
+        const auto& get() const & noexcept {
+            return static_cast<const element_type<I>&>(*this).get();
+        }
+
+        template<std::size_t I>
+        [[nodiscard]]
+        auto&& get() && noexcept {
+            return std::move(static_cast<element_type<I>&>(*this).get());
+        }
+
+    private:
+
+        template<std::size_t I>
+        using element_type = Callable_pack_element<I, type_list_element_t<I, Type_list<Ts...>>>;
+
+    };
+
+    ///
+    /// A tuple of callable objects which occupies no storage for those that
+    /// are empty. A pack of stateless callables is itself empty and
+    /// trivially copyable, and so is stored in function wrappers without
+    /// taking up any of the small buffer.
+    ///
+    /// @tparam Ts Callable object types
+    template<class...Ts>
+    using Callable_pack = Callable_pack_base<std::index_sequence_for<Ts...>, Ts...>;
+
+    //=====================================================
+    // Type traits
+    //=====================================================
+
+    ///
+    /// Result of invoking the composition of Fs with Args. Has no member type
+    /// if any step of the composition isn't invocable.
+    ///
+    template<class Args_list, class...Fs>
+    struct Composition_result {};
+
+    template<class F, class Inner, class = void>
+    struct Invoke_with_result {};
+
+    template<class F, class Inner>
+    struct Invoke_with_result<F, Inner, std::void_t<typename Inner::type>> : std::invoke_result<F, typename Inner::type> {};
+
+    template<class...Args, class F>
+    struct Composition_result<Type_list<Args...>, F> : std::invoke_result<F, Args...> {};
+
+    template<class...Args, class F, class G, class...Fs>
+    struct Composition_result<Type_list<Args...>, F, G, Fs...> : Invoke_with_result<F, Composition_result<Type_list<Args...>, G, Fs...>> {};
+
+    template<class Args_list, class...Fs>
+    using composition_result_t = typename Composition_result<Args_list, Fs...>::type;
+
+    //=====================================================
+    // Composition
+    //=====================================================
+
+    ///
+    /// Callable object which passes its arguments to the last of Fs and the
+    /// result of each callable to the one before it, returning the result of
+    /// the first.
+    ///
+    /// Created by compose(). All callables are held in a single object, so
+    /// a composition of concrete callables is stored in a function wrapper
+    /// as one callable and invoked through one indirect call, with the
+    /// steps in between open to inlining.
+    ///
+    /// @tparam Fs Callable object types. Each one but the last must be
+    /// invocable with the result of the one after it
+    template<class...Fs>
+    class Composition : public Callable_pack<Fs...> {
+        static_assert(sizeof...(Fs) != 0, "A composition requires at least one callable");
+
+        using pack_base = Callable_pack<Fs...>;
+
+    public:
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        using pack_base::pack_base;
+
+        //=================================================
+        // Call operators
+        //=================================================
+
+        template<class...Args>
+        composition_result_t<Type_list<Args&&...>, Fs&...> operator()(Args&&...args) {
+            return call<0>(*this, std::forward<Args>(args)...);
+        }
+
+        template<class...Args>
+        composition_result_t<Type_list<Args&&...>, const Fs&...> operator()(Args&&...args) const {
+            return call<0>(*this, std::forward<Args>(args)...);
+        }
+
+    private:
+
+        //=================================================
+        // Helper functions
+        //=================================================
+
+        template<std::size_t I, class Self, class...Args>
+        static decltype(auto) call(Self& self, Args&&...args) {
+            if constexpr (I + 1 == sizeof...(Fs)) {
+                return std::invoke(self.template get<I>(), std::forward<Args>(args)...);
+            } else {
+                return std::invoke(self.template get<I>(), call<I + 1>(self, std::forward<Args>(args)...));
+            }
+        }
+
+    };
+
+    //=====================================================
+    // Front_binder
+    //=====================================================
+
+    ///
+    /// Callable object which invokes a callable with a fixed sequence of
+    /// leading arguments followed by the arguments it was called with.
+    ///
+    /// Created by bind_front(). The bound arguments are passed as lvalues,
+    /// const if the binder is.
+    ///
+    /// @tparam F Callable object type
+    /// @tparam Bound Types of bound arguments
+    template<class F, class...Bound>
+    class Front_binder : public Callable_pack<F, Bound...> {
+        using pack_base = Callable_pack<F, Bound...>;
+
+    public:
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        using pack_base::pack_base;
+
+        //=================================================
+        // Call operators
+        //=================================================
+
+        template<class...Args>
+        std::invoke_result_t<F&, Bound&..., Args&&...> operator()(Args&&...args) {
+            return call(*this, std::index_sequence_for<Bound...>{}, std::forward<Args>(args)...);
+        }
+
+        template<class...Args>
+        std::invoke_result_t<const F&, const Bound&..., Args&&...> operator()(Args&&...args) const {
+            return call(*this, std::index_sequence_for<Bound...>{}, std::forward<Args>(args)...);
+        }
+
+    private:
+
+        //=================================================
+        // Helper functions
+        //=================================================
+
+        template<class Self, std::size_t...Is, class...Args>
+        static decltype(auto) call(Self& self, std::index_sequence<Is...>, Args&&...args) {
+            return std::invoke(self.template get<0>(), self.template get<Is + 1>()..., std::forward<Args>(args)...);
+        }
+
+    };
+
+    template<class...Fs>
+    struct is_trivially_relocatable<Composition<Fs...>> : std::conjunction<is_trivially_relocatable<Fs>...> {};
+
+    template<class F, class...Bound>
+    struct is_trivially_relocatable<Front_binder<F, Bound...>> : std::conjunction<is_trivially_relocatable<F>, is_trivially_relocatable<Bound>...> {};
+
+    //=====================================================
+    // Factory functions
+    //=====================================================
+
+    template<class T>
+    struct Is_composition : std::false_type {};
+
+    template<class...Fs>
+    struct Is_composition<Composition<Fs...>> : std::true_type {};
+
+    template<class T>
+    struct Is_front_binder : std::false_type {};
+
+    template<class F, class...Bound>
+    struct Is_front_binder<Front_binder<F, Bound...>> : std::true_type {};
+
+    template<class F>
+    struct Composition_operand_count : std::integral_constant<std::size_t, 1> {};
+
+    template<class...Fs>
+    struct Composition_operand_count<Composition<Fs...>> : std::integral_constant<std::size_t, sizeof...(Fs)> {};
+
+    ///
+    /// Maps positions in a flattened composition to the operand of compose()
+    /// they come from and their position within that operand
+    ///
+    template<class...Fs>
+    struct Composition_layout {
+        static constexpr std::size_t counts[] = {Composition_operand_count<Fs>::value...};
+
+        static constexpr std::size_t size = (Composition_operand_count<Fs>::value + ...);
+
+        [[nodiscard]]
+        static constexpr std::size_t operand_of(std::size_t k) {
+            std::size_t operand = 0;
+            while (k >= counts[operand]) {
+                k -= counts[operand];
+                ++operand;
+            }
+            return operand;
+        }
+
+        [[nodiscard]]
+        static constexpr std::size_t element_of(std::size_t k) {
+            std::size_t operand = 0;
+            while (k >= counts[operand]) {
+                k -= counts[operand];
+                ++operand;
+            }
+            return k;
+        }
+    };
+
+    template<std::size_t E, class F>
+    struct Composition_operand_element {
+        using type = F;
+    };
+
+    template<std::size_t E, class...Fs>
+    struct Composition_operand_element<E, Composition<Fs...>> : Type_list_element<E, Type_list<Fs...>> {};
+
+    template<std::size_t N, class First, class...Rest>
+    [[nodiscard]]
+    decltype(auto) nth_argument(First&& first, Rest&&...rest) noexcept {
+        if constexpr (N == 0) {
+            return std::forward<First>(first);
+        } else {
+            return nth_argument<N - 1>(std::forward<Rest>(rest)...);
+        }
+    }
+
+    ///
+    /// @return Callable E of f if it's a Composition, f itself otherwise
+    template<std::size_t E, class F>
+    [[nodiscard]]
+    decltype(auto) composition_operand(F&& f) noexcept {
+        if constexpr (Is_composition<std::decay_t<F>>::value) {
+            return std::forward<F>(f).template get<E>();
+        } else {
+            return std::forward<F>(f);
+        }
+    }
+
+    template<std::size_t...Ks, class...Fs>
+    [[nodiscard]]
+    auto compose_flattened(std::index_sequence<Ks...>, Fs&&...fs) {
+        using layout = Composition_layout<std::decay_t<Fs>...>;
+        using result_type = Composition<typename Composition_operand_element<
+            layout::element_of(Ks),
+            std::decay_t<type_list_element_t<layout::operand_of(Ks), Type_list<Fs...>>>
+        >::type...>;
+
+        return result_type{
+            std::in_place,
+            composition_operand<layout::element_of(Ks)>(nth_argument<layout::operand_of(Ks)>(std::forward<Fs>(fs)...))...
+        };
+    }
+
+    template<class Binder, std::size_t...Is, class...Args>
+    [[nodiscard]]
+    auto extend_front_binder(Binder&& binder, std::index_sequence<Is...>, Args&&...args) {
+        using binder_type = std::decay_t<Binder>;
+        using result_type = Front_binder<
+            std::decay_t<decltype(std::declval<binder_type&>().template get<Is>())>...,
+            std::decay_t<Args>...
+        >;
+
+        return result_type{std::in_place, std::forward<Binder>(binder).template get<Is>()..., std::forward<Args>(args)...};
+    }
+
+    template<class F>
+    struct Front_binder_size;
+
+    template<class F, class...Bound>
+    struct Front_binder_size<Front_binder<F, Bound...>> : std::integral_constant<std::size_t, 1 + sizeof...(Bound)> {};
+
+    ///
+    /// Composes callables into a single callable object such that
+    /// compose(f, g, h)(args...) is equivalent to f(g(h(args...))).
+    ///
+    /// Operands which are themselves compositions are flattened into the
+    /// result rather than nested inside it.
+    ///
+    /// @param fs Callable objects. Copied or moved into the result
+    /// @return Composition of decayed callable types
+    template<class...Fs>
+    [[nodiscard]]
+    auto compose(Fs&&...fs) {
+        using layout = Composition_layout<std::decay_t<Fs>...>;
+        return compose_flattened(std::make_index_sequence<layout::size>{}, std::forward<Fs>(fs)...);
+    }
+
+    ///
+    /// Binds args to the first parameters of f. bind_front(f, a, b)(c) is
+    /// equivalent to f(a, b, c).
+    ///
+    /// If f is itself the result of bind_front(), args are appended to its
+    /// bound arguments instead of wrapping it.
+    ///
+    /// In C++20, argument-dependent lookup may also find std::bind_front, so
+    /// calls should be qualified.
+    ///
+    /// @param f Callable object. Copied or moved into the result
+    /// @param args Arguments to bind. Copied or moved into the result
+    /// @return Front_binder of decayed types
+    template<class F, class...Args>
+    [[nodiscard]]
+    auto bind_front(F&& f, Args&&...args) {
+        if constexpr (Is_front_binder<std::decay_t<F>>::value) {
+            constexpr std::size_t size = Front_binder_size<std::decay_t<F>>::value;
+            return extend_front_binder(std::forward<F>(f), std::make_index_sequence<size>{}, std::forward<Args>(args)...);
+        } else {
+            return Front_binder<std::decay_t<F>, std::decay_t<Args>...>{std::in_place, std::forward<F>(f), std::forward<Args>(args)...};
+        }
+    }
+
+}
+
+#endif //ATUL_COMPOSITION_HPP
@@ -0,0 +1,757 @@
+#ifndef ATUL_COROUTINE_HPP
+#define ATUL_COROUTINE_HPP
+
+#include "Function.hpp"
+#include "Timer_wheel.hpp"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#define ATUL_HAS_COROUTINES
+
+#include <aul/containers/Allocator_aware_base.hpp>
+
+#include <coroutine>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace atul {
+
+    //=====================================================
+    // Frame allocation
+    //=====================================================
+
+    ///
+    /// Unit in which coroutine frames are requested from allocators
+    ///
+    struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) Frame_block {
+        std::byte bytes[__STDCPP_DEFAULT_NEW_ALIGNMENT__];
+    };
+
+    ///
+    /// Promise base class which obtains coroutine frames from an allocator.
+    ///
+    /// A coroutine whose first parameters are std::allocator_arg followed by
+    /// an allocator, or a member coroutine whose first parameters are such,
+    /// has its frame allocated through a copy of that allocator rebound to
+    /// Frame_block. Other coroutines use std::allocator.
+    ///
+    /// The frame is followed by a pointer to the matching deallocation
+    /// function and the allocator itself, so that operator delete, which
+    /// only receives the frame's address and size, can return the frame to
+    /// where it came from.
+    ///
+    class Frame_allocating_promise {
+    public:
+
+        //=================================================
+        // Allocation functions
+        //=================================================
+
+        static void* operator new(std::size_t size) {
+            return allocate_frame(std::allocator<Frame_block>{}, size);
+        }
+
+        template<class Alloc, class...Args>
+        static void* operator new(std::size_t size, std::allocator_arg_t, const Alloc& a, const Args&...) {
+            return allocate_frame(a, size);
+        }
+
+        template<class This, class Alloc, class...Args>
+        static void* operator new(std::size_t size, const This&, std::allocator_arg_t, const Alloc& a, const Args&...) {
+            return allocate_frame(a, size);
+        }
+
+        static void operator delete(void* frame, std::size_t size) noexcept {
+            deallocator_type deallocate = nullptr;
+            std::memcpy(&deallocate, static_cast<std::byte*>(frame) + deallocator_offset(size), sizeof(deallocator_type));
+            deallocate(frame, size);
+        }
+
+    private:
+
+        //=================================================
+        // Type aliases
+        //=================================================
+
+        using deallocator_type = void (*)(void*, std::size_t) noexcept;
+
+        //=================================================
+        // Helper functions
+        //=================================================
+
+        [[nodiscard]]
+        static constexpr std::size_t deallocator_offset(std::size_t size) {
+            return compute_sbo_size(size, alignof(deallocator_type));
+        }
+
+        template<class Block_allocator>
+        [[nodiscard]]
+        static constexpr std::size_t allocator_offset(std::size_t size) {
+            return compute_sbo_size(deallocator_offset(size) + sizeof(deallocator_type), alignof(Block_allocator));
+        }
+
+        template<class Block_allocator>
+        [[nodiscard]]
+        static constexpr std::size_t block_count(std::size_t size) {
+            return compute_sbo_size(allocator_offset<Block_allocator>(size) + sizeof(Block_allocator), sizeof(Frame_block)) / sizeof(Frame_block);
+        }
+
+        template<class Alloc>
+        [[nodiscard]]
+        static void* allocate_frame(const Alloc& a, std::size_t size) {
+            using block_allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<Frame_block>;
+            static_assert(alignof(block_allocator_type) <= alignof(Frame_block));
+
+            block_allocator_type allocator{a};
+            Frame_block* blocks = std::allocator_traits<block_allocator_type>::allocate(allocator, block_count<block_allocator_type>(size));
+            auto* frame = reinterpret_cast<std::byte*>(blocks);
+
+            deallocator_type deallocate = &deallocate_frame<block_allocator_type>;
+            std::memcpy(frame + deallocator_offset(size), &deallocate, sizeof(deallocator_type));
+            new (frame + allocator_offset<block_allocator_type>(size)) block_allocator_type(std::move(allocator));
+
+            return frame;
+        }
+
+        template<class Block_allocator>
+        static void deallocate_frame(void* frame, std::size_t size) noexcept {
+            auto* stored = std::launder(reinterpret_cast<Block_allocator*>(static_cast<std::byte*>(frame) + allocator_offset<Block_allocator>(size)));
+            Block_allocator allocator{std::move(*stored)};
+            stored->~Block_allocator();
+
+            std::allocator_traits<Block_allocator>::deallocate(allocator, static_cast<Frame_block*>(frame), block_count<Block_allocator>(size));
+        }
+
+    };
+
+    //=====================================================
+    // Task
+    //=====================================================
+
+    template<class T = void>
+    class Task;
+
+    template<class A, std::size_t SB_size>
+    class AA_SBO_event_loop;
+
+    ///
+    /// Promise state common to all Task types
+    ///
+    class Task_promise_base : public Frame_allocating_promise {
+    public:
+
+        //=================================================
+        // Coroutine customization points
+        //=================================================
+
+        [[nodiscard]]
+        std::suspend_always initial_suspend() const noexcept {
+            return {};
+        }
+
+        ///
+        /// On completion, control transfers directly to the awaiting
+        /// coroutine, if any. A detached task destroys its own frame.
+        ///
+        [[nodiscard]]
+        auto final_suspend() const noexcept {
+            return Final_awaiter{};
+        }
+
+        void unhandled_exception() noexcept {
+            exception = std::current_exception();
+        }
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        std::coroutine_handle<> continuation{};
+
+        std::exception_ptr exception{};
+
+        bool detached = false;
+
+    private:
+
+        struct Final_awaiter {
+            [[nodiscard]]
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            template<class Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept {
+                Task_promise_base& promise = h.promise();
+                if (promise.continuation) {
+                    return promise.continuation;
+                }
+
+                if (promise.detached) {
+                    if (promise.exception) {
+                        std::terminate();
+                    }
+                    h.destroy();
+                }
+
+                return std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+    };
+
+    template<class T>
+    class Task_promise : public Task_promise_base {
+        static_assert(!std::is_reference_v<T>, "Task results must be object types");
+
+    public:
+
+        [[nodiscard]]
+        Task<T> get_return_object() noexcept {
+            return Task<T>{std::coroutine_handle<Task_promise>::from_promise(*this)};
+        }
+
+        template<class U = T>
+        void return_value(U&& value) {
+            result.emplace(std::forward<U>(value));
+        }
+
+        [[nodiscard]]
+        T take_result() {
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+
+            return std::move(*result);
+        }
+
+    private:
+
+        std::optional<T> result;
+
+    };
+
+    template<>
+    class Task_promise<void> : public Task_promise_base {
+    public:
+
+        [[nodiscard]]
+        Task<void> get_return_object() noexcept;
+
+        void return_void() const noexcept {}
+
+        void take_result() {
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+        }
+
+    };
+
+    ///
+    /// A lazily started coroutine which produces a value of type T.
+    ///
+    /// A Task does not run until it is awaited, spawned on an event loop, or
+    /// run with AA_SBO_event_loop::run_until_complete(). Awaiting a task
+    /// transfers control to it, and its completion transfers control
+    /// straight back to the awaiting coroutine, so a chain of tasks awaiting
+    /// each other neither allocates nor goes through the event loop.
+    ///
+    /// Frames are allocated as described by Frame_allocating_promise: pass
+    /// std::allocator_arg and an allocator as the coroutine's first
+    /// arguments to place the frame in, for example, an arena.
+    ///
+    /// Exceptions thrown by the coroutine are rethrown to whoever awaits it.
+    ///
+    /// @tparam T Result type. May be void
+    template<class T>
+    class [[nodiscard]] Task {
+    public:
+
+        //=================================================
+        // Type aliases
+        //=================================================
+
+        using promise_type = Task_promise<T>;
+
+        using handle_type = std::coroutine_handle<promise_type>;
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        Task() noexcept = default;
+
+        explicit Task(handle_type handle) noexcept:
+            handle(handle) {}
+
+        Task(const Task&) = delete;
+
+        Task(Task&& other) noexcept:
+            handle(std::exchange(other.handle, {})) {}
+
+        ~Task() {
+            if (handle) {
+                handle.destroy();
+            }
+        }
+
+        //=================================================
+        // Assignment operators
+        //=================================================
+
+        Task& operator=(const Task&) = delete;
+
+        Task& operator=(Task&& rhs) noexcept {
+            if (this != &rhs) {
+                if (handle) {
+                    handle.destroy();
+                }
+                handle = std::exchange(rhs.handle, {});
+            }
+
+            return *this;
+        }
+
+        //=================================================
+        // co_await operator
+        //=================================================
+
+        [[nodiscard]]
+        auto operator co_await() && noexcept {
+            struct Awaiter {
+                handle_type handle;
+
+                [[nodiscard]]
+                bool await_ready() const noexcept {
+                    return !handle || handle.done();
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                    handle.promise().continuation = awaiting;
+                    return handle;
+                }
+
+                T await_resume() {
+                    if (!handle) {
+                        throw std::logic_error{"atul::Task: Awaited empty task"};
+                    }
+
+                    return handle.promise().take_result();
+                }
+            };
+
+            return Awaiter{handle};
+        }
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        [[nodiscard]]
+        bool done() const noexcept {
+            return handle && handle.done();
+        }
+
+        [[nodiscard]]
+        explicit operator bool() const noexcept {
+            return static_cast<bool>(handle);
+        }
+
+    private:
+
+        template<class A, std::size_t SB_size>
+        friend class AA_SBO_event_loop;
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        handle_type handle{};
+
+    };
+
+    inline Task<void> Task_promise<void>::get_return_object() noexcept {
+        return Task<void>{std::coroutine_handle<Task_promise>::from_promise(*this)};
+    }
+
+    ///
+    /// Callable object which resumes a suspended coroutine. Small and
+    /// trivially copyable, so it's always stored inline by function wrappers.
+    ///
+    struct Coroutine_resumer {
+        std::coroutine_handle<> handle;
+
+        void operator()() const {
+            handle.resume();
+        }
+    };
+
+    //=====================================================
+    // AA_SBO_event_loop
+    //=====================================================
+
+    ///
+    /// A single-threaded executor which runs posted callbacks and resumes
+    /// coroutines in the order they were scheduled.
+    ///
+    /// Callbacks are stored as AA_SBO_unique_function objects in a vector
+    /// which is drained one batch at a time. Callbacks posted while a batch
+    /// runs go into the next batch. Both vectors keep their capacity, so a
+    /// loop in a steady state doesn't allocate, and the callbacks which
+    /// resume coroutines always fit in the small buffer.
+    ///
+    /// Coroutines which are suspended on the loop when it's destroyed are
+    /// not resumed and their frames are not freed.
+    ///
+    /// @tparam A STL compatible allocator type
+    /// @tparam SB_size Size of each callback's small buffer
+    template<class A, std::size_t SB_size>
+    class AA_SBO_event_loop : public aul::Allocator_aware_base<typename std::allocator_traits<A>::template rebind_alloc<std::byte>> {
+        using a_base = aul::Allocator_aware_base<typename std::allocator_traits<A>::template rebind_alloc<std::byte>>;
+
+    public:
+
+        //=================================================
+        // Type aliases
+        //=================================================
+
+        using allocator_type = typename std::allocator_traits<A>::template rebind_alloc<std::byte>;
+
+        using function_type = AA_SBO_unique_function<allocator_type, SB_size, void()>;
+
+        using size_type = std::size_t;
+
+    private:
+
+        using function_allocator_type = typename std::allocator_traits<A>::template rebind_alloc<function_type>;
+
+    public:
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        explicit AA_SBO_event_loop(const allocator_type& a = {}):
+            a_base(a),
+            ready(function_allocator_type{a}),
+            running(function_allocator_type{a}) {}
+
+        AA_SBO_event_loop(const AA_SBO_event_loop&) = delete;
+
+        AA_SBO_event_loop(AA_SBO_event_loop&&) = delete;
+
+        ~AA_SBO_event_loop() = default;
+
+        //=================================================
+        // Assignment operators
+        //=================================================
+
+        AA_SBO_event_loop& operator=(const AA_SBO_event_loop&) = delete;
+
+        AA_SBO_event_loop& operator=(AA_SBO_event_loop&&) = delete;
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        ///
+        /// @return True if there are no callbacks waiting to run
+        [[nodiscard]]
+        bool empty() const noexcept {
+            return ready.empty() && next_running == running.size();
+        }
+
+        //=================================================
+        // Modifiers
+        //=================================================
+
+        ///
+        /// Queues c to be invoked by run()
+        ///
+        /// @param c Callable object or function_type
+        template<class C>
+        void post(C&& c) {
+            if constexpr (std::is_same_v<std::decay_t<C>, function_type>) {
+                ready.push_back(std::forward<C>(c));
+            } else {
+                ready.push_back(function_type{a_base::get_allocator(), std::forward<C>(c)});
+            }
+        }
+
+        ///
+        /// Starts task on the next call to run(). The task's frame is
+        /// destroyed when it completes. If it completes with an exception,
+        /// std::terminate() is called.
+        ///
+        /// @param task Task to run in the background
+        template<class T>
+        void spawn(Task<T> task) {
+            std::coroutine_handle<Task_promise<T>> handle = std::exchange(task.handle, {});
+            if (!handle) {
+                return;
+            }
+
+            handle.promise().detached = true;
+            try {
+                post(Coroutine_resumer{handle});
+            } catch (...) {
+                handle.destroy();
+                throw;
+            }
+        }
+
+        //=================================================
+        // Misc.
+        //=================================================
+
+        ///
+        /// Invokes queued callbacks, including ones queued while running, until
+        /// none remain. If a callback throws, the exception propagates and the
+        /// callbacks after it are left queued.
+        ///
+        /// @return Number of callbacks invoked
+        size_type run() {
+            size_type count = 0;
+            while (true) {
+                if (next_running == running.size()) {
+                    running.clear();
+                    next_running = 0;
+
+                    if (ready.empty()) {
+                        return count;
+                    }
+
+                    std::swap(ready, running);
+                }
+
+                function_type& callback = running[next_running++];
+                ++count;
+                callback();
+            }
+        }
+
+        ///
+        /// Runs task and every other callback on the loop until none remain
+        ///
+        /// @param task Task to run
+        /// @return The task's result
+        /// @throws std::logic_error if the loop runs out of work before the task
+        /// completes
+        template<class T>
+        T run_until_complete(Task<T> task) {
+            if (!task.handle) {
+                throw std::logic_error{"atul::AA_SBO_event_loop::run_until_complete(): Empty task"};
+            }
+
+            post(Coroutine_resumer{task.handle});
+            run();
+
+            if (!task.handle.done()) {
+                throw std::logic_error{"atul::AA_SBO_event_loop::run_until_complete(): Task suspended with no work queued"};
+            }
+
+            return task.handle.promise().take_result();
+        }
+
+        ///
+        /// @return Awaitable which suspends the awaiting coroutine and
+        /// queues its resumption on this loop
+        [[nodiscard]]
+        auto schedule() noexcept {
+            struct Schedule_awaiter {
+                AA_SBO_event_loop* loop;
+
+                [[nodiscard]]
+                bool await_ready() const noexcept {
+                    return false;
+                }
+
+                void await_suspend(std::coroutine_handle<> h) {
+                    loop->post(Coroutine_resumer{h});
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+            return Schedule_awaiter{this};
+        }
+
+    private:
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        std::vector<function_type, function_allocator_type> ready;
+
+        std::vector<function_type, function_allocator_type> running;
+
+        size_type next_running = 0;
+
+    };
+
+    //=====================================================
+    // Awaiters
+    //=====================================================
+
+    ///
+    /// Signature of the callback handed to the initiator of await_callback()
+    ///
+    template<class T>
+    struct Callback_signature {
+        using type = void(T);
+    };
+
+    template<>
+    struct Callback_signature<void> {
+        using type = void();
+    };
+
+    template<class T>
+    using Callback_signature_t = typename Callback_signature<T>::type;
+
+    ///
+    /// Awaitable which bridges callback-based asynchronous operations to
+    /// coroutines. See await_callback().
+    ///
+    /// @tparam T Type of the value the operation completes with. May be void
+    /// @tparam Initiator Callable invoked with the resumption callback
+    template<class T, class Initiator>
+    class Callback_awaiter {
+        struct Resumer {
+            Callback_awaiter* awaiter;
+
+            std::coroutine_handle<> handle;
+
+            template<class...Values>
+            void operator()(Values&&...values) const {
+                if constexpr (sizeof...(Values) != 0) {
+                    awaiter->result.emplace(std::forward<Values>(values)...);
+                }
+                handle.resume();
+            }
+        };
+
+    public:
+
+        //=================================================
+        // Type aliases
+        //=================================================
+
+        using callback_type = SBO_unique_function<sizeof(Resumer), Callback_signature_t<T>>;
+
+        static_assert(callback_type::template stores_inline<Resumer>);
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        explicit Callback_awaiter(Initiator initiator):
+            initiator(std::move(initiator)) {}
+
+        //=================================================
+        // Awaiter interface
+        //=================================================
+
+        [[nodiscard]]
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> h) {
+            std::invoke(initiator, callback_type{Resumer{this, h}});
+        }
+
+        T await_resume() {
+            if constexpr (!std::is_void_v<T>) {
+                return std::move(*result);
+            }
+        }
+
+    private:
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        Initiator initiator;
+
+        std::optional<std::conditional_t<std::is_void_v<T>, std::monostate, T>> result;
+
+    };
+
+    ///
+    /// Suspends the awaiting coroutine and passes initiator a callback which
+    /// resumes it. The value the callback is invoked with becomes the result
+    /// of the co_await expression.
+    ///
+    /// The callback is a move-only function wrapper whose small buffer fits
+    /// the resumption state exactly, so awaiting never allocates. It must be
+    /// invoked exactly once, and it resumes the coroutine on the invoking
+    /// thread.
+    ///
+    /// @tparam T Type of the value the operation completes with. May be void
+    /// @param initiator Callable which starts the operation, taking
+    /// ownership of the callback
+    template<class T = void, class Initiator>
+    [[nodiscard]]
+    Callback_awaiter<T, std::decay_t<Initiator>> await_callback(Initiator&& initiator) {
+        return Callback_awaiter<T, std::decay_t<Initiator>>{std::forward<Initiator>(initiator)};
+    }
+
+    ///
+    /// Suspends the awaiting coroutine until wheel reaches deadline
+    ///
+    /// @param wheel Timer wheel whose advance() resumes the coroutine
+    /// @param deadline Tick at which to resume. Does not suspend if the
+    /// wheel's time is already past it
+    template<class A, std::size_t SB_size>
+    [[nodiscard]]
+    auto sleep_until(AA_SBO_timer_wheel<A, SB_size>& wheel, typename AA_SBO_timer_wheel<A, SB_size>::time_type deadline) {
+        struct Timer_awaiter {
+            AA_SBO_timer_wheel<A, SB_size>* wheel;
+
+            typename AA_SBO_timer_wheel<A, SB_size>::time_type deadline;
+
+            [[nodiscard]]
+            bool await_ready() const noexcept {
+                return deadline <= wheel->now();
+            }
+
+            void await_suspend(std::coroutine_handle<> h) {
+                wheel->schedule(deadline, Coroutine_resumer{h});
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        return Timer_awaiter{&wheel, deadline};
+    }
+
+    //=====================================================
+    // Convenience type aliases
+    //=====================================================
+
+    using Event_loop = AA_SBO_event_loop<std::allocator<std::byte>, 32>;
+
+    template<std::size_t SB_size>
+    using SBO_event_loop = AA_SBO_event_loop<std::allocator<std::byte>, SB_size>;
+
+}
+
+#endif
+
+#endif //ATUL_COROUTINE_HPP
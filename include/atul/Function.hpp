@@ -2,10 +2,20 @@
 #define ATUL_FUNCTION_HPP
 
 #include "Misc.hpp"
-
-#include <aul/containers/Allocator_aware_base.hpp>
+#include "Relocation.hpp"
+#include "Allocators.hpp"
+#include "Function_statistics.hpp"
 
 #include <memory_resource>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <typeinfo>
+#include <type_traits>
+#include <utility>
+#include <new>
+#include <stdexcept>
+#include <cstring>
 
 namespace atul {
 
@@ -18,39 +28,103 @@ namespace atul {
         return (size_request / alignment_request + static_cast<bool>(size_request % alignment_request)) * alignment_request;
     }
 
+    //=====================================================
+    // Parameter passing
+    //=====================================================
+
+    ///
+    /// True if arguments of type T are passed by value between function
+    /// wrappers and the callables they wrap. This holds for trivially
+    /// copyable object types no larger than two pointers, which common ABIs
+    /// pass in registers.
+    ///
+    template<class T>
+    inline constexpr bool is_passed_by_value_v =
+        std::is_object_v<T> &&
+        std::is_trivially_copyable_v<T> &&
+        sizeof(T) <= 2 * sizeof(void*);
+
+    ///
+    /// Parameter type through which an argument declared as T in a signature
+    /// is handed to a wrapped callable exactly once
+    ///
+    template<class T>
+    using forwarded_parameter_t = std::conditional_t<is_passed_by_value_v<T>, T, T&&>;
+
+    ///
+    /// Parameter type through which an argument declared as T in a signature
+    /// is handed to several callables in turn
+    ///
+    template<class T>
+    using shared_parameter_t = std::conditional_t<is_passed_by_value_v<T>, T, T&>;
+
     //=====================================================
     // Callable wrappers
     //=====================================================
 
     ///
-    /// Virtual interface which presents a uniform interface for calling
-    /// functions wrapped by instance of Callable_wrapper template classes.
+    /// Table of type-erased operations which presents a uniform interface for
+    /// calling and managing functions wrapped by instances of Callable_wrapper
+    /// template classes.
+    ///
+    /// Exactly one table exists per Callable_wrapper instantiation and storage
+    /// strategy. Since the wrapper objects themselves carry no vptr,
+    /// dispatching through a table never requires a load out of the wrapped
+    /// object.
     ///
     template<class Ret, class...Args>
-    struct Callable_interface {
+    struct Callable_operations {
+
+        ///
+        /// Invokers take the address of the storage of the owning object
+        /// rather than the address of the wrapper itself. For inline storage
+        /// these are the same. Otherwise the storage holds a pointer to the
+        /// wrapper.
+        ///
+        using invoker_type = Ret (*)(std::byte*, forwarded_parameter_t<Args>...);
+
+        invoker_type invoke;
+
+        void (*destroy)(void*) noexcept;
 
-        virtual ~Callable_interface() = default;
+        void (*move_constructor_delegate)(void*, std::byte*);
 
-        virtual Ret call(Args&&...args) = 0;
+        void (*copy_constructor_delegate)(const void*, std::byte*);
 
-        virtual void move_constructor_delegate(std::byte* ptr) = 0;
+        std::size_t size_of;
 
-        virtual void copy_constructor_delegate(std::byte* ptr) = 0;
+        std::size_t align_of;
 
-        virtual std::size_t size_of() = 0;
+        bool is_inline;
 
-        virtual const std::type_info& target_type() = 0;
+        ///
+        /// True if the wrapper is stored inline and is trivially copyable, in
+        /// which case copying it is a copy of bytes and destroying it is a
+        /// no-op
+        ///
+        bool is_trivial;
 
-        virtual void* target() = 0;
+        ///
+        /// True if the storage of the owning object may be moved to a new
+        /// address by copying its bytes. This holds for callables reached
+        /// through a pointer and for inline callables which are trivially
+        /// relocatable. Other inline callables are moved with
+        /// move_constructor_delegate.
+        ///
+        bool is_trivially_relocatable;
+
+        const std::type_info& (*target_type)() noexcept;
+
+        void* (*target)(void*) noexcept;
     };
 
     ///
     /// Templated wrapper around callable types which implement a common
-    /// interface.
+    /// interface through a static table of operations.
     ///
     /// @tparam Callable A callable type
     template<class Callable, class Ret, class...Args>
-    struct Callable_wrapper final : Callable_interface<Ret, Args...> {
+    struct Callable_wrapper final {
 
         explicit Callable_wrapper(const Callable& c):
             callable(c)
@@ -58,6 +132,19 @@ namespace atul {
             static_assert(std::is_copy_constructible_v<Callable>);
         }
 
+        explicit Callable_wrapper(Callable&& c):
+            callable(std::move(c))
+        {
+            static_assert(std::is_move_constructible_v<Callable>);
+        }
+
+        ///
+        /// Constructs the callable directly from ctor_args
+        ///
+        template<class...Ctor_args>
+        explicit Callable_wrapper(std::in_place_t, Ctor_args&&...ctor_args):
+            callable(std::forward<Ctor_args>(ctor_args)...) {}
+
         Callable_wrapper(const Callable_wrapper& other):
             callable(other.callable)
         {
@@ -65,99 +152,421 @@ namespace atul {
         }
 
         Callable_wrapper(Callable_wrapper&& other) :
-            callable(std::forward<Callable>(other.callable))
+            callable(std::move(other.callable))
         {
             static_assert(std::is_move_constructible_v<Callable>);
         }
 
-        Ret call(Args&&...args) override {
-            return callable(std::forward<Args>(args)...);
+        template<bool Is_const, bool Is_noexcept>
+        static Ret call(std::byte* storage, forwarded_parameter_t<Args>...args) noexcept(Is_noexcept) {
+            return invoke<Is_const>(*std::launder(reinterpret_cast<Callable_wrapper*>(storage)), std::forward<Args>(args)...);
         }
 
-        void move_constructor_delegate(std::byte* ptr) override {
-            static_assert(std::is_move_constructible_v<Callable>);
-            new (ptr) Callable_wrapper{std::move(*this)};
+        template<bool Is_const, bool Is_noexcept>
+        static Ret call_indirect(std::byte* storage, forwarded_parameter_t<Args>...args) noexcept(Is_noexcept) {
+            auto* self = static_cast<Callable_wrapper*>(*std::launder(reinterpret_cast<void**>(storage)));
+            return invoke<Is_const>(*self, std::forward<Args>(args)...);
         }
 
-        void copy_constructor_delegate(std::byte* ptr) override {
-            static_assert(std::is_copy_constructible_v<Callable>);
-            new (ptr) Callable_wrapper{*this};
+        ///
+        /// Invokes the callable, as a const object if Is_const is true, and
+        /// discards its result if Ret is void
+        ///
+        template<bool Is_const>
+        static Ret invoke(Callable_wrapper& self, forwarded_parameter_t<Args>...args) {
+            using callable_reference = std::conditional_t<Is_const, const Callable&, Callable&>;
+
+            if constexpr (std::is_void_v<Ret>) {
+                std::invoke(static_cast<callable_reference>(self.callable), std::forward<Args>(args)...);
+            } else {
+                return std::invoke(static_cast<callable_reference>(self.callable), std::forward<Args>(args)...);
+            }
+        }
+
+        static void destroy(void* self) noexcept {
+            static_cast<Callable_wrapper*>(self)->~Callable_wrapper();
+        }
+
+        static void move_constructor_delegate(void* self, std::byte* ptr) {
+            new (ptr) Callable_wrapper{std::move(*static_cast<Callable_wrapper*>(self))};
         }
 
-        std::size_t size_of() override {
-            return sizeof(Callable_wrapper);
+        static void copy_constructor_delegate(const void* self, std::byte* ptr) {
+            new (ptr) Callable_wrapper{*static_cast<const Callable_wrapper*>(self)};
         }
 
-        const std::type_info& target_type() override {
+        static constexpr auto move_constructor_delegate_if_movable() {
+            using delegate_type = void (*)(void*, std::byte*);
+            if constexpr (std::is_move_constructible_v<Callable>) {
+                return delegate_type{&move_constructor_delegate};
+            } else {
+                return delegate_type{nullptr};
+            }
+        }
+
+        static constexpr auto copy_constructor_delegate_if_copyable() {
+            using delegate_type = void (*)(const void*, std::byte*);
+            if constexpr (std::is_copy_constructible_v<Callable>) {
+                return delegate_type{&copy_constructor_delegate};
+            } else {
+                return delegate_type{nullptr};
+            }
+        }
+
+        static const std::type_info& target_type() noexcept {
             return typeid(Callable);
         }
 
-        void* target() override {
-            return reinterpret_cast<void*>(&callable);
+        static void* target(void* self) noexcept {
+            return reinterpret_cast<void*>(&static_cast<Callable_wrapper*>(self)->callable);
         }
 
         Callable callable;
     };
 
-    template<class Ret, class...Args>
-    struct Callable_wrapper<Ret(Args...), Ret, Args...> final : Callable_interface<Ret, Args...> {
+    ///
+    /// The operations table for a particular Callable_wrapper instantiation.
+    /// Is_inline indicates whether the wrapper lives directly in the storage
+    /// of the owning object or is reached through a pointer held there.
+    /// Is_const and Is_noexcept select an invoker which calls the callable as
+    /// a const object and which is declared noexcept, respectively.
+    ///
+    /// The copy constructor delegate is null for callables which are not copy
+    /// constructible. Such callables may only be stored by move-only
+    /// AA_SBO_function instantiations. Likewise, the move constructor
+    /// delegate is null for callables which are not move constructible.
+    ///
+    template<class Callable, bool Is_inline, bool Is_const, bool Is_noexcept, class Ret, class...Args>
+    inline constexpr Callable_operations<Ret, Args...> qualified_callable_operations {
+        Is_inline ?
+            &Callable_wrapper<Callable, Ret, Args...>::template call<Is_const, Is_noexcept> :
+            &Callable_wrapper<Callable, Ret, Args...>::template call_indirect<Is_const, Is_noexcept>,
+        &Callable_wrapper<Callable, Ret, Args...>::destroy,
+        Callable_wrapper<Callable, Ret, Args...>::move_constructor_delegate_if_movable(),
+        Callable_wrapper<Callable, Ret, Args...>::copy_constructor_delegate_if_copyable(),
+        sizeof(Callable_wrapper<Callable, Ret, Args...>),
+        alignof(Callable_wrapper<Callable, Ret, Args...>),
+        Is_inline,
+        Is_inline && std::is_trivially_copyable_v<Callable_wrapper<Callable, Ret, Args...>>,
+        !Is_inline || is_trivially_relocatable_v<Callable>,
+        &Callable_wrapper<Callable, Ret, Args...>::target_type,
+        &Callable_wrapper<Callable, Ret, Args...>::target
+    };
 
-        using Callable = Ret(Args...);
+    ///
+    /// The operations table for callables invoked through an unqualified
+    /// signature
+    ///
+    template<class Callable, bool Is_inline, class Ret, class...Args>
+    inline constexpr const Callable_operations<Ret, Args...>& callable_operations =
+        qualified_callable_operations<Callable, Is_inline, false, false, Ret, Args...>;
 
-        explicit Callable_wrapper(const Callable&) {}
+    //=====================================================
+    // Small buffer sizing
+    //=====================================================
 
-        Callable_wrapper(const Callable_wrapper&) {}
+    ///
+    /// @tparam Callable Decayed callable type
+    /// @param buffer_size Size of small buffer
+    /// @param buffer_alignment Alignment of small buffer
+    /// @return True if a callable of type Callable may be stored in a small
+    /// buffer of the specified size and alignment
+    template<class Callable, class Ret, class...Args>
+    [[nodiscard]]
+    constexpr bool fits_in_small_buffer(std::size_t buffer_size, std::size_t buffer_alignment) {
+        using callable_type = Callable_wrapper<Callable, Ret, Args...>;
+        constexpr std::size_t required_size = sizeof(callable_type);
+        constexpr std::size_t required_alignment = alignof(callable_type);
+
+        return
+            (required_size <= buffer_size) &&
+            (required_alignment <= buffer_alignment) &&
+            std::is_nothrow_move_constructible_v<Callable>;
+    }
 
-        Callable_wrapper(Callable_wrapper&&) noexcept {}
+    ///
+    /// True for callables which carry no state beyond, at most, a function
+    /// pointer: function pointers themselves and empty, trivially copyable
+    /// classes such as captureless lambdas. AA_SBO_function always stores
+    /// these inline, regardless of the size of its small buffer.
+    ///
+    /// @tparam Callable Decayed callable type
+    template<class Callable>
+    inline constexpr bool is_stateless_callable_v =
+        (std::is_pointer_v<Callable> && std::is_function_v<std::remove_pointer_t<Callable>>) ||
+        (std::is_empty_v<Callable> && std::is_trivially_copyable_v<Callable>);
 
-        Ret call(Args&&...args) override {
-            return callable(std::forward<Args>(args)...);
-        }
+    template<class T>
+    struct Is_in_place_type : std::false_type {};
+
+    template<class T>
+    struct Is_in_place_type<std::in_place_type_t<T>> : std::true_type {};
+
+    template<class T>
+    inline constexpr bool is_in_place_type_v = Is_in_place_type<T>::value;
+
+    template<class C, class...Callables>
+    struct Recommended_sbo_size;
+
+    ///
+    /// Computes the smallest SB_size for which an AA_SBO_function with
+    /// signature Ret(Args...) stores all of the specified callables in its
+    /// small buffer, accounting for the overhead of Callable_wrapper.
+    ///
+    /// Stateless callables need no small buffer and contribute nothing.
+    /// Callables which can never be stored inline, because they're
+    /// over-aligned or their move constructor may throw, are rejected at
+    /// compile time.
+    ///
+    /// @tparam Callables Callable types
+    template<class Ret, class...Args, class...Callables>
+    struct Recommended_sbo_size<Ret(Args...), Callables...> {
+        static_assert(
+            (std::is_nothrow_move_constructible_v<std::decay_t<Callables>> && ...),
+            "Callables whose move constructor may throw are never stored in the small buffer"
+        );
+
+        static_assert(
+            ((alignof(Callable_wrapper<std::decay_t<Callables>, Ret, Args...>) <= alignof(std::max_align_t)) && ...),
+            "Over-aligned callables are only stored in a small buffer with an explicit alignment"
+        );
+
+        static constexpr std::size_t value = std::max({
+            std::size_t{0},
+            (is_stateless_callable_v<std::decay_t<Callables>> ? 0 : sizeof(Callable_wrapper<std::decay_t<Callables>, Ret, Args...>))...
+        });
+    };
+
+    ///
+    /// Smallest SB_size for which an AA_SBO_function with signature C stores
+    /// every one of Callables in its small buffer.
+    ///
+    template<class C, class...Callables>
+    inline constexpr std::size_t recommended_sbo_size_v = Recommended_sbo_size<C, Callables...>::value;
+
+    //=====================================================
+    // Function signatures
+    //=====================================================
+
+    template<bool Is_const, bool Is_noexcept, class Ret, class...Args>
+    struct Signature_traits_base {
+        static constexpr bool is_const = Is_const;
+
+        static constexpr bool is_noexcept = Is_noexcept;
+
+        using return_type = Ret;
+
+        using operations_type = Callable_operations<Ret, Args...>;
 
-        void move_constructor_delegate(std::byte* ptr) override {
-            new (ptr) Callable_wrapper{std::move(*this)};
+        using invoker_type = Ret (*)(std::byte*, forwarded_parameter_t<Args>...) noexcept(Is_noexcept);
+
+        template<class Callable>
+        using wrapper_type = Callable_wrapper<Callable, Ret, Args...>;
+
+        template<class Callable, bool Is_inline>
+        [[nodiscard]]
+        static constexpr const operations_type& operations() noexcept {
+            return qualified_callable_operations<Callable, Is_inline, Is_const, Is_noexcept, Ret, Args...>;
         }
 
-        void copy_constructor_delegate(std::byte* ptr) override {
-            new (ptr) Callable_wrapper{*this};
+        ///
+        /// Whether a callable of type Callable may be called through this
+        /// signature. Callables of noexcept signatures must not throw.
+        ///
+        template<class Callable>
+        static constexpr bool is_compatible = Is_noexcept ?
+            std::is_nothrow_invocable_r_v<Ret, std::conditional_t<Is_const, const Callable&, Callable&>, Args...> :
+            std::is_invocable_r_v<Ret, std::conditional_t<Is_const, const Callable&, Callable&>, Args...>;
+
+        template<class Callable>
+        [[nodiscard]]
+        static constexpr bool fits(std::size_t buffer_size, std::size_t buffer_alignment) {
+            return fits_in_small_buffer<Callable, Ret, Args...>(buffer_size, buffer_alignment);
         }
 
-        std::size_t size_of() override {
-            return sizeof(Callable_wrapper);
+        ///
+        /// The operations table stores invokers without their noexcept
+        /// qualification. This restores it.
+        ///
+        [[nodiscard]]
+        static invoker_type invoker_of(const operations_type& ops) noexcept {
+            return reinterpret_cast<invoker_type>(ops.invoke);
         }
+    };
 
-        const std::type_info& target_type() override {
-            return typeid(Callable);
+    ///
+    /// Describes a function signature of the form Ret(Args...), optionally
+    /// qualified with const and/or noexcept.
+    ///
+    template<class C>
+    struct Signature_traits;
+
+    template<class Ret, class...Args, bool Is_noexcept>
+    struct Signature_traits<Ret(Args...) noexcept(Is_noexcept)> : Signature_traits_base<false, Is_noexcept, Ret, Args...> {};
+
+    template<class Ret, class...Args, bool Is_noexcept>
+    struct Signature_traits<Ret(Args...) const noexcept(Is_noexcept)> : Signature_traits_base<true, Is_noexcept, Ret, Args...> {};
+
+    ///
+    /// Base class of function wrappers which supplies a call operator with
+    /// the qualifiers of the signature C. F must expose members named
+    /// invoker and sbo_buffer to this class.
+    ///
+    /// The noexcept forms have no empty-state check. Calling an empty
+    /// function through one of them is undefined behavior.
+    ///
+    template<class F, class C>
+    class Function_call_operator;
+
+    template<class F, class Ret, class...Args, bool Is_noexcept>
+    class Function_call_operator<F, Ret(Args...) noexcept(Is_noexcept)> {
+    public:
+
+        Ret operator()(Args...args) noexcept(Is_noexcept) {
+            F& self = static_cast<F&>(*this);
+            if constexpr (!Is_noexcept) {
+                if (!self.invoker) {
+                    throw std::bad_function_call();
+                }
+            }
+
+            return self.invoker(self.sbo_buffer, std::forward<Args>(args)...);
         }
 
-        void* target() override {
-            return reinterpret_cast<void*>(&callable);
+    };
+
+    template<class F, class Ret, class...Args, bool Is_noexcept>
+    class Function_call_operator<F, Ret(Args...) const noexcept(Is_noexcept)> {
+    public:
+
+        Ret operator()(Args...args) const noexcept(Is_noexcept) {
+            const F& self = static_cast<const F&>(*this);
+            if constexpr (!Is_noexcept) {
+                if (!self.invoker) {
+                    throw std::bad_function_call();
+                }
+            }
+
+            // The invoker only accesses the callable as a const object
+            return self.invoker(const_cast<std::byte*>(self.sbo_buffer), std::forward<Args>(args)...);
         }
 
-        Callable callable;
     };
 
     //=====================================================
     // AA_SBO_function
     //=====================================================
 
-    template<class A, std::size_t SB_size, class C>
+    template<
+        class A,
+        std::size_t SB_size,
+        class C,
+        bool Is_copyable = true,
+        class Observer = Default_function_observer,
+        std::size_t Align = alignof(std::max_align_t)
+    >
     class AA_SBO_function;
 
     ///
     /// An allocator-aware alternative to std::function which also optionally
     /// uses a small buffer optimization.
     ///
+    /// The invoker of the wrapped callable is stored directly within the
+    /// object so that a call costs a single indirect jump. Less frequent
+    /// operations are dispatched through a per-type Callable_operations table.
+    ///
+    /// Callables are stored in the small buffer if they fit, are no more
+    /// strictly aligned than Align, and have a non-throwing move
+    /// constructor. Otherwise the small buffer holds a pointer to an
+    /// allocation, which is aligned for the callable even if that exceeds
+    /// alignof(std::max_align_t).
+    ///
+    /// Moving the object copies the bytes of its storage when it holds a
+    /// pointer or a trivially relocatable callable, and otherwise goes
+    /// through the callable's move constructor. Without a small buffer the
+    /// object is therefore always trivially relocatable.
+    ///
+    /// Function pointers and captureless lambdas are stored inline even when
+    /// SB_size is 0, and are copied and destroyed without going through
+    /// their operations table. A null function pointer produces an empty
+    /// function.
     ///
+    /// When Is_copyable is false, the resulting type is move-only and may wrap
+    /// callables which are not copy constructible, such as lambdas which own
+    /// a std::unique_ptr. No copy path is instantiated for such objects.
+    ///
+    /// The Observer is notified whenever a callable is placed in or removed
+    /// from storage. See Function_statistics.hpp.
+    ///
+    /// The signature C has the form Ret(Args...) and may be qualified with
+    /// const, in which case wrapped callables are invoked as const objects,
+    /// and with noexcept, in which case wrapped callables must not throw and
+    /// calling an empty function is undefined behavior rather than throwing
+    /// std::bad_function_call.
     ///
     /// @tparam A STL compatible allocator type
     /// @tparam SB_size Target size of internal small buffer. Will be rounded up
-    /// if it can be done without increasing size of struct.
-    /// @tparam Ret Callable return type
-    /// @tparam Args Callable argument types
-    template<class A, std::size_t SB_size, class Ret, class...Args>
-    class AA_SBO_function<A, SB_size, Ret (Args...)> : public aul::Allocator_aware_base<typename std::allocator_traits<A>::template rebind_alloc<std::byte>> {
-        using a_base = aul::Allocator_aware_base<typename std::allocator_traits<A>::template rebind_alloc<std::byte>>;
+    /// if it can be done without increasing size of struct. A value of 0
+    /// disables the small buffer optimization.
+    /// @tparam C Function signature
+    /// @tparam Is_copyable Whether the resulting type is copyable
+    /// @tparam Observer Type notified of storage events
+    /// @tparam Align Alignment of internal small buffer. Callables with
+    /// stricter alignment requirements are stored in allocated storage
+    template<class A, std::size_t SB_size, class C, bool Is_copyable, class Observer, std::size_t Align>
+    class AA_SBO_function : public Function_call_operator<AA_SBO_function<A, SB_size, C, Is_copyable, Observer, Align>, C> {
+        using allocator_traits = std::allocator_traits<typename std::allocator_traits<A>::template rebind_alloc<std::byte>>;
+
+        using signature_traits = Signature_traits<C>;
+
+        using operations_type = typename signature_traits::operations_type;
+
+        using invoker_type = typename signature_traits::invoker_type;
+
+        friend class Function_call_operator<AA_SBO_function, C>;
+
+        template<class, std::size_t, class, bool, class, std::size_t>
+        friend class AA_SBO_function;
+
+        template<class Callable>
+        static constexpr bool is_wrappable_v =
+            !std::is_same_v<std::decay_t<Callable>, AA_SBO_function> &&
+            !std::is_same_v<std::decay_t<Callable>, std::nullptr_t> &&
+            !is_in_place_type_v<std::decay_t<Callable>>;
+
+        ///
+        /// Stand-in parameter type for the copy constructor and copy
+        /// assignment operator of move-only instantiations. Those then cease to
+        /// be copy operations and the implicit ones are deleted.
+        ///
+        struct Deleted_copy {};
+
+        ///
+        /// Stand-in parameter type for the conversion from the copyable
+        /// variant, which only move-only instantiations provide
+        ///
+        struct Deleted_conversion {};
+
+        using copy_source_type = std::conditional_t<Is_copyable, AA_SBO_function, Deleted_copy>;
+
+        using copyable_source_type = std::conditional_t<
+            Is_copyable,
+            Deleted_conversion,
+            AA_SBO_function<A, SB_size, C, true, Observer, Align>
+        >;
+
+        ///
+        /// Unit in which allocated storage is requested. Rebinding the
+        /// allocator to a sufficiently aligned block type makes any allocator
+        /// which honors alignof(T) return storage suitable for the callable.
+        ///
+        template<std::size_t Alignment>
+        struct alignas(Alignment) Storage_block {
+            std::byte bytes[Alignment];
+        };
+
+        template<std::size_t Alignment>
+        using block_allocator_type = typename allocator_traits::template rebind_alloc<Storage_block<Alignment>>;
 
     public:
 
@@ -165,20 +574,36 @@ namespace atul {
         // Constants
         //=================================================
 
+        ///
+        /// Without a small buffer, the storage only ever holds a pointer or
+        /// a stateless callable, so it need not be more than pointer-aligned
+        ///
+        static constexpr std::size_t small_buffer_alignment = SB_size == 0 ? alignof(void*) : Align;
+
         static constexpr std::size_t small_buffer_size =
-            compute_sbo_size(
-                SB_size,
-                std::max(
-                    alignof(void*),
-                    alignof(a_base)
-                )
-            );
+            compute_sbo_size(SB_size, small_buffer_alignment);
+
+        ///
+        /// Strictest alignment supported for callables held in allocated
+        /// storage
+        ///
+        static constexpr std::size_t max_alignment = 256;
+
+        ///
+        /// Whether a callable of type Callable is stored in the small buffer
+        /// rather than in allocated storage. Stateless callables always are,
+        /// since the buffer is never smaller than a pointer.
+        ///
+        template<class Callable>
+        static constexpr bool stores_inline =
+            is_stateless_callable_v<std::decay_t<Callable>> ||
+            signature_traits::template fits<std::decay_t<Callable>>(small_buffer_size, small_buffer_alignment);
 
         //=================================================
         // Type aliases
         //=================================================
 
-        using return_type = Ret;
+        using return_type = typename signature_traits::return_type;
 
         using allocator_type = typename std::allocator_traits<A>::template rebind_alloc<std::byte>;
 
@@ -190,62 +615,118 @@ namespace atul {
 
         AA_SBO_function() = default;
 
-        explicit AA_SBO_function(std::nullptr_t):
-            callable() {}
+        explicit AA_SBO_function(std::nullptr_t) {}
 
-        AA_SBO_function(const AA_SBO_function& other):
-            a_base(other)
+        AA_SBO_function(const copy_source_type& other):
+            allocator_and_operations(allocator_traits::select_on_container_copy_construction(other.get_allocator()), nullptr)
         {
-            if (!other.callable) {
+            if (!other.operations()) {
                 return;
             }
 
-            if (other.is_sbo_in_use()) {
-                other.callable->copy_constructor_delegate(sbo_buffer);
-                callable = reinterpret_cast<Callable_interface<Ret, Args...>*>(sbo_buffer);
-            } else {
-                acquire_callable(other.callable);
-            }
+            copy_callable(other);
         }
 
         AA_SBO_function(AA_SBO_function&& other) noexcept:
-            a_base(std::move(other)),
-            callable(std::exchange(other.callable, nullptr))
+            invoker(std::exchange(other.invoker, nullptr)),
+            allocator_and_operations(other.get_allocator(), std::exchange(other.operations(), nullptr))
         {
-            if (!other.callable) {
-                return;
-            }
+            relocate_storage(other);
+        }
 
-            if (other.is_sbo_in_use()) {
-                other.callable->move_constructor_delegate(sbo_buffer);
-                callable = reinterpret_cast<Callable_interface<Ret, Args...>*>(sbo_buffer);
-            } else {
-                acquire_callable(other.callable);
+        ///
+        /// Takes over the callable held by the copyable variant of this type
+        /// rather than wrapping the copyable function as a callable in its own
+        /// right. Both variants share a storage layout.
+        ///
+        AA_SBO_function(copyable_source_type&& other) noexcept:
+            invoker(std::exchange(other.invoker, nullptr)),
+            allocator_and_operations(other.get_allocator(), std::exchange(other.operations(), nullptr))
+        {
+            const operations_type* ops = operations();
+            relocate_buffer(ops, other.sbo_buffer, sbo_buffer);
+            if (ops) {
+                Observer::template on_release<copyable_source_type>(ops->is_inline, ops->is_inline ? 0 : ops->size_of);
+                Observer::template on_acquire<AA_SBO_function>(ops->is_inline, ops->is_inline ? 0 : ops->size_of);
             }
         }
 
-        template<class Callable>
+        template<class Callable, class = std::enable_if_t<is_wrappable_v<Callable>>>
         AA_SBO_function(const allocator_type& a, Callable&& callable):
-            a_base(a),
-            callable()
+            allocator_and_operations(a, nullptr)
         {
-            acquire_callable<Callable>(std::forward<Callable>(callable));
+            acquire_callable(std::forward<Callable>(callable));
         }
 
-        template<class Callable>
+        template<class Callable, class = std::enable_if_t<is_wrappable_v<Callable>>>
         explicit AA_SBO_function(Callable&& callable):
             AA_SBO_function(allocator_type{}, std::forward<Callable>(callable)) {}
 
         template<class Callable>
         AA_SBO_function(const allocator_type& a, Callable* callable):
-            a_base(a)
+            allocator_and_operations(a, nullptr)
         {
-            acquire_callable<Callable*>(callable);
+            if (callable) {
+                acquire_callable(callable);
+            }
         }
 
         template<class Callable>
         explicit AA_SBO_function(Callable* callable):
-            AA_SBO_function(A{}, callable) {}
+            AA_SBO_function(allocator_type{}, callable) {}
+
+        ///
+        /// Constructs a callable of type T from ctor_args directly in the
+        /// storage it will occupy. T need not be movable, in which case it is
+        /// always held in allocated storage.
+        ///
+        template<class T, class...Ctor_args>
+        explicit AA_SBO_function(std::in_place_type_t<T>, Ctor_args&&...ctor_args):
+            AA_SBO_function(std::allocator_arg, allocator_type{}, std::in_place_type<T>, std::forward<Ctor_args>(ctor_args)...) {}
+
+        //=================================================
+        // Allocator-extended -ctors
+        //=================================================
+
+        // These follow the uses-allocator construction protocol so that
+        // containers such as std::pmr::vector pass their allocator on to
+        // their elements
+
+        AA_SBO_function(std::allocator_arg_t, const allocator_type& a) noexcept:
+            allocator_and_operations(a, nullptr) {}
+
+        AA_SBO_function(std::allocator_arg_t, const allocator_type& a, std::nullptr_t) noexcept:
+            allocator_and_operations(a, nullptr) {}
+
+        AA_SBO_function(std::allocator_arg_t, const allocator_type& a, const copy_source_type& other):
+            allocator_and_operations(a, nullptr)
+        {
+            if (other.operations()) {
+                copy_callable(other);
+            }
+        }
+
+        ///
+        /// Takes over the callable held by other. If other's allocation can't
+        /// be released through a, the callable is instead moved into storage
+        /// obtained from a.
+        ///
+        AA_SBO_function(std::allocator_arg_t, const allocator_type& a, AA_SBO_function&& other):
+            allocator_and_operations(a, nullptr)
+        {
+            take_callable(other);
+        }
+
+        template<class Callable, class = std::enable_if_t<is_wrappable_v<Callable>>>
+        AA_SBO_function(std::allocator_arg_t, const allocator_type& a, Callable&& callable):
+            AA_SBO_function(a, std::forward<Callable>(callable)) {}
+
+        template<class T, class...Ctor_args>
+        AA_SBO_function(std::allocator_arg_t, const allocator_type& a, std::in_place_type_t<T>, Ctor_args&&...ctor_args):
+            allocator_and_operations(a, nullptr)
+        {
+            emplace_callable<T>(std::forward<Ctor_args>(ctor_args)...);
+        }
 
         ~AA_SBO_function() {
             release_callable();
@@ -255,69 +736,70 @@ namespace atul {
         // Assignment operators
         //=================================================
 
-        AA_SBO_function& operator=(const AA_SBO_function& rhs) noexcept {
+        ///
+        /// Copies rhs's callable into storage obtained from the allocator
+        /// this object will hold after propagation. The copy is made before
+        /// the current callable is released, so if allocation or the
+        /// callable's copy constructor throws, this object is unchanged.
+        ///
+        AA_SBO_function& operator=(const copy_source_type& rhs) {
             if (this == &rhs) {
                 return *this;
             }
 
-            release_callable();
-            a_base::operator=(rhs);
-
-            if (!rhs.callable) {
-                return *this;
-            }
+            constexpr bool propagate = allocator_traits::propagate_on_container_copy_assignment::value;
+            AA_SBO_function copy{std::allocator_arg, propagate ? rhs.get_allocator() : get_allocator(), rhs};
 
-            std::byte* target = nullptr;
-            if (rhs.is_sbo_in_use()) {
-                target = sbo_buffer;
-            } else {
-                auto allocator = a_base::get_allocator();
-                target = allocator.allocate(rhs.callable->size_of());
+            release_callable();
+            if constexpr (propagate) {
+                allocator_and_operations.allocator() = rhs.get_allocator();
             }
 
-            rhs.callable->copy_constructor_delegate(target);
-            callable = reinterpret_cast<Callable_interface<Ret, Args...>*>(target);
+            // Allocators are now equal, so this transfers copy's storage
+            take_callable(copy);
 
             return *this;
         }
 
-        AA_SBO_function& operator=(AA_SBO_function&& rhs) noexcept {
+        ///
+        /// Takes over rhs's allocation if the allocators compare equal after
+        /// propagation. Otherwise rhs's callable is moved into storage
+        /// obtained from this object's allocator, which may throw.
+        ///
+        AA_SBO_function& operator=(AA_SBO_function&& rhs) noexcept(
+            allocator_traits::propagate_on_container_move_assignment::value ||
+            allocator_traits::is_always_equal::value
+        ) {
             if (this == &rhs) {
                 return *this;
             }
 
             release_callable();
-            a_base::operator=(rhs);
-
-            if (!rhs.callable) {
-                return *this;
+            if constexpr (allocator_traits::propagate_on_container_move_assignment::value) {
+                allocator_and_operations.allocator() = rhs.get_allocator();
             }
 
-            std::byte* target = nullptr;
-            if (rhs.is_sbo_in_use()) {
-                target = sbo_buffer;
-            } else {
-                auto allocator = a_base::get_allocator();
-                target = allocator.allocate(rhs.callable->size_of());
-            }
+            take_callable(rhs);
 
-            rhs.callable->move_constructor_delegate(target);
-            callable = reinterpret_cast<Callable_interface<Ret, Args...>*>(target);
+            return *this;
+        }
 
+        template<class Callable, class = std::enable_if_t<is_wrappable_v<Callable>>>
+        AA_SBO_function& operator=(Callable&& callable) {
+            release_callable();
+            acquire_callable(std::forward<Callable>(callable));
             return *this;
         }
 
-        template<class C>
-        AA_SBO_function& operator=(C&& callable) {
+        template<class T>
+        AA_SBO_function& operator=(std::reference_wrapper<T> callable) {
             release_callable();
-            this->callable = acquire_callable(callable);
+            acquire_callable(callable);
             return *this;
         }
 
-        template<class C>
-        AA_SBO_function& operator=(std::reference_wrapper<C> callable) noexcept {
+        AA_SBO_function& operator=(std::nullptr_t) noexcept {
             release_callable();
-            this->callable = acquire_callable(callable);
             return *this;
         }
 
@@ -325,15 +807,20 @@ namespace atul {
         // Accessors
         //=================================================
 
+        [[nodiscard]]
+        allocator_type get_allocator() const noexcept {
+            return allocator_and_operations.allocator();
+        }
+
         [[nodiscard]]
         explicit operator bool() const {
-            return callable == nullptr;
+            return invoker != nullptr;
         }
 
         [[nodiscard]]
         const std::type_info& target_type() const noexcept {
-            if (callable) {
-                return callable->target_type();
+            if (operations()) {
+                return operations()->target_type();
             } else {
                 return typeid(void);
             }
@@ -342,34 +829,68 @@ namespace atul {
         template<class T>
         [[nodiscard]]
         T* target() noexcept {
-            if  (typeid(T) == target_type() && callable) {
-                return reinterpret_cast<T*>(callable->target());
+            if  (operations() && typeid(T) == target_type()) {
+                return reinterpret_cast<T*>(operations()->target(wrapper_address()));
             } else {
                 return nullptr;
             }
         }
 
+        //=================================================
+        // Modifiers
+        //=================================================
+
+        ///
+        /// Destroys the held callable, if any, and constructs a callable of
+        /// type T from ctor_args directly in the storage it will occupy
+        ///
+        /// @return Reference to newly constructed callable
+        template<class T, class...Ctor_args>
+        T& emplace(Ctor_args&&...ctor_args) {
+            release_callable();
+            return emplace_callable<T>(std::forward<Ctor_args>(ctor_args)...);
+        }
+
         //=================================================
         // Misc.
         //=================================================
 
-        void swap(AA_SBO_function& other) noexcept {
-            //TODO: Consider using swap function from allocator-aware base
-            if (is_sbo_is_use()) {
-                AA_SBO_function tmp = std::move(*this);
-                *this = std::move(other);
-                other = std::move(tmp);
-            } else {
-                //TODO: Complete
+        ///
+        /// Exchanges the callables held by this object and other. Allocators
+        /// are exchanged only if they propagate on swap.
+        ///
+        /// If the allocators compare equal, or propagate, allocations change
+        /// hands and nothing is allocated. Otherwise each callable held in
+        /// allocated storage is moved into storage obtained from its new
+        /// owner's allocator, which may throw.
+        ///
+        void swap(AA_SBO_function& other) noexcept(
+            allocator_traits::propagate_on_container_swap::value ||
+            allocator_traits::is_always_equal::value
+        ) {
+            if (this == &other) {
+                return;
             }
-        }
 
-        Ret operator()(Args&&...args) {
-            if (!callable) {
-                throw std::bad_function_call();
+            if constexpr (allocator_traits::propagate_on_container_swap::value) {
+                using std::swap;
+                swap(allocator_and_operations.allocator(), other.allocator_and_operations.allocator());
+            } else if constexpr (!allocator_traits::is_always_equal::value) {
+                if (get_allocator() != other.get_allocator()) {
+                    AA_SBO_function tmp{std::allocator_arg, other.get_allocator(), std::move(*this)};
+                    *this = std::move(other);
+                    other = std::move(tmp);
+                    return;
+                }
             }
 
-            return callable->call(std::forward<Args>(args)...);
+            alignas(small_buffer_alignment) std::byte tmp[sizeof(sbo_buffer)];
+            relocate_buffer(operations(), sbo_buffer, tmp);
+            relocate_buffer(other.operations(), other.sbo_buffer, sbo_buffer);
+            relocate_buffer(operations(), tmp, other.sbo_buffer);
+
+            std::swap(invoker, other.invoker);
+            std::swap(operations(), other.operations());
         }
 
     private:
@@ -378,263 +899,420 @@ namespace atul {
         // Instance members
         //=================================================
 
-        Callable_interface<Ret, Args...>* callable = nullptr;
+        ///
+        /// Copy of operations->invoke, kept alongside the storage of the
+        /// wrapped callable so that calls don't have to go through the table
+        ///
+        invoker_type invoker = nullptr;
 
-        std::byte sbo_buffer[small_buffer_size] {};
+        ///
+        /// The operations of the wrapped callable, stored together with the
+        /// allocator so that a stateless allocator takes up no space
+        ///
+        Allocator_pair<allocator_type, const operations_type*> allocator_and_operations{};
+
+        ///
+        /// Holds either the wrapped callable itself or a pointer to the
+        /// allocation containing it, as indicated by operations->is_inline
+        ///
+        alignas(small_buffer_alignment) std::byte sbo_buffer[std::max(small_buffer_size, sizeof(void*))] {};
 
         //=================================================
         // Helper functions
         //=================================================
 
         [[nodiscard]]
-        bool is_sbo_is_use() {
-            return reinterpret_cast<std::byte*>(callable) == sbo_buffer;
+        const operations_type*& operations() noexcept {
+            return allocator_and_operations.value();
         }
 
-        template<class Callable>
-        void acquire_callable(const Callable& c) {
-            using callable_type = Callable_wrapper<Callable, Ret, Args...>;
-            constexpr std::size_t required_size = sizeof(callable_type);
-            constexpr std::size_t required_alignment = alignof(callable_type);
+        [[nodiscard]]
+        const operations_type* operations() const noexcept {
+            return allocator_and_operations.value();
+        }
 
-            const bool use_sb =
-                (std::extent_v<decltype(sbo_buffer)> <= required_size) &&
-                required_alignment <= alignof(decltype(sbo_buffer));
+        [[nodiscard]]
+        bool is_sbo_in_use() const {
+            return operations() && operations()->is_inline;
+        }
 
-            if (use_sb) {
-                auto* alloc = reinterpret_cast<Callable_wrapper<Callable, Ret, Args...>*>(sbo_buffer);
-                new (alloc) Callable_wrapper<Callable, Ret, Args...>(c);
-                callable = alloc;
+        [[nodiscard]]
+        void* wrapper_address() const {
+            if (operations()->is_inline) {
+                return const_cast<std::byte*>(sbo_buffer);
             } else {
-                auto allocator = a_base::get_allocator();
-                std::byte* allocation = allocator.allocate(sizeof(Callable_wrapper<Callable, Ret, Args...>));
-                if (allocation == nullptr) {
-                    throw std::bad_alloc();
-                }
-
-                auto* alloc = reinterpret_cast<Callable_wrapper<Callable, Ret, Args...>*>(allocation);
-                new (alloc) Callable_wrapper<Callable, Ret, Args...>(c);
-
-                callable = alloc;
+                return *std::launder(reinterpret_cast<void* const*>(sbo_buffer));
             }
         }
 
-        template<class Callable>
-        void acquire_callable(Callable&& c) {
-            using callable_type = Callable_wrapper<Callable, Ret, Args...>;
-            constexpr std::size_t required_size = sizeof(callable_type);
-            constexpr std::size_t required_alignment = alignof(callable_type);
+        void store_pointer(void* ptr) {
+            new (sbo_buffer) void*{ptr};
+        }
 
-            const bool use_sb =
-                (std::extent_v<decltype(sbo_buffer)> <= required_size) &&
-                required_alignment <= alignof(decltype(sbo_buffer));
+        ///
+        /// Takes over the storage of other, whose operations must already
+        /// have been transferred to this object
+        ///
+        void relocate_storage(AA_SBO_function& other) noexcept {
+            relocate_buffer(operations(), other.sbo_buffer, sbo_buffer);
+        }
 
-            if (use_sb) {
-                auto* alloc = reinterpret_cast<Callable_wrapper<Callable, Ret, Args...>*>(sbo_buffer);
-                new (alloc) Callable_wrapper<Callable, Ret, Args...>(std::forward<Callable>(c));
-                callable = alloc;
+        ///
+        /// Moves the contents of storage described by ops from source to
+        /// dest, leaving source without a live object. A copy of bytes
+        /// unless the storage holds a callable which isn't trivially
+        /// relocatable, whose move constructor is then known not to throw.
+        ///
+        static void relocate_buffer(const operations_type* ops, std::byte* source, std::byte* dest) noexcept {
+            if (!ops || ops->is_trivially_relocatable) {
+                std::memcpy(dest, source, sizeof(sbo_buffer));
             } else {
-                auto allocator = a_base::get_allocator();
-                std::byte* allocation = allocator.allocate(sizeof(Callable_wrapper<Callable, Ret, Args...>));
-                if (allocation == nullptr) {
-                    throw std::bad_alloc();
-                }
-
-                auto* alloc = reinterpret_cast<Callable_wrapper<Callable, Ret, Args...>*>(allocation);
-                new (alloc) Callable_wrapper<Callable, Ret, Args...>(std::forward<Callable>(c));
-
-                callable = alloc;
+                ops->move_constructor_delegate(source, dest);
+                ops->destroy(source);
             }
         }
 
-        void release_callable() {
-            if (is_sbo_is_use()) {
-                callable->~Callable_interface();
-            } else {
-                if (callable) {
-                    callable->~Callable_interface();
-                    auto allocator = a_base::get_allocator();
-                    allocator.deallocate(reinterpret_cast<std::byte*>(callable), sizeof(*callable));
-                }
+        [[nodiscard]]
+        std::byte* allocate_storage(const operations_type& ops, bool use_sb) {
+            if (use_sb) {
+                return sbo_buffer;
             }
-        }
 
-    };
+            std::byte* allocation = allocate_blocks(ops.size_of, ops.align_of);
+            if (allocation == nullptr) {
+                throw std::bad_alloc();
+            }
 
-    template<class A, class Ret, class...Args>
-    class AA_SBO_function<A, 0, Ret(Args...)> : public aul::Allocator_aware_base<typename std::allocator_traits<A>::template rebind_alloc<std::byte>> {
-        using a_base = aul::Allocator_aware_base<typename std::allocator_traits<A>::template rebind_alloc<std::byte>>;
+            return allocation;
+        }
 
-    public:
+        void deallocate_storage(std::byte* allocation, const operations_type& ops) noexcept {
+            if constexpr (!is_deallocation_noop_v<allocator_type>) {
+                deallocate_blocks(allocation, ops.size_of, ops.align_of);
+            }
+        }
 
-        //=================================================
-        // Type aliases
-        //=================================================
+        ///
+        /// Allocates storage for size bytes through the allocator rebound to
+        /// the least aligned block type which satisfies alignment
+        ///
+        template<std::size_t Alignment = alignof(void*)>
+        [[nodiscard]]
+        std::byte* allocate_blocks(std::size_t size, std::size_t alignment) {
+            if constexpr (Alignment < max_alignment) {
+                if (Alignment < alignment) {
+                    return allocate_blocks<Alignment * 2>(size, alignment);
+                }
+            }
 
-        using return_type = Ret;
+            block_allocator_type<Alignment> allocator{get_allocator()};
+            auto* blocks = std::allocator_traits<block_allocator_type<Alignment>>::allocate(allocator, (size + Alignment - 1) / Alignment);
+            return reinterpret_cast<std::byte*>(blocks);
+        }
 
-        using allocator_type = typename std::allocator_traits<A>::template rebind_alloc<std::byte>;
+        template<std::size_t Alignment = alignof(void*)>
+        void deallocate_blocks(std::byte* allocation, std::size_t size, std::size_t alignment) noexcept {
+            if constexpr (Alignment < max_alignment) {
+                if (Alignment < alignment) {
+                    deallocate_blocks<Alignment * 2>(allocation, size, alignment);
+                    return;
+                }
+            }
 
-        using pointer = typename std::allocator_traits<A>::pointer;
+            block_allocator_type<Alignment> allocator{get_allocator()};
+            auto* blocks = reinterpret_cast<Storage_block<Alignment>*>(allocation);
+            std::allocator_traits<block_allocator_type<Alignment>>::deallocate(allocator, blocks, (size + Alignment - 1) / Alignment);
+        }
 
-        //=================================================
-        // -ctors
-        //=================================================
+        void copy_callable(const AA_SBO_function& other) {
+            if (other.operations()->is_trivial) {
+                invoker = other.invoker;
+                operations() = other.operations();
+                std::memcpy(sbo_buffer, other.sbo_buffer, sizeof(sbo_buffer));
+                Observer::template on_acquire<AA_SBO_function>(true, 0);
+                return;
+            }
 
-        AA_SBO_function() = default;
+            const bool use_sb = other.is_sbo_in_use();
+            std::byte* target = allocate_storage(*other.operations(), use_sb);
 
-        explicit AA_SBO_function(std::nullptr_t):
-            callable() {}
+            try {
+                other.operations()->copy_constructor_delegate(other.wrapper_address(), target);
+            } catch (...) {
+                if (!use_sb) {
+                    deallocate_storage(target, *other.operations());
+                }
+                throw;
+            }
+            invoker = other.invoker;
+            operations() = other.operations();
+            if (!use_sb) {
+                store_pointer(target);
+            }
+            Observer::template on_acquire<AA_SBO_function>(use_sb, use_sb ? 0 : operations()->size_of);
+        }
 
-        AA_SBO_function(const AA_SBO_function& other):
-            a_base(other)
-        {
-            if (!other.callable) {
+        ///
+        /// Moves the callable held by other into this object, which must be
+        /// empty, and leaves other empty. Ownership of an allocation is only
+        /// transferred if the two allocators compare equal.
+        ///
+        void take_callable(AA_SBO_function& other) {
+            if (!other.operations()) {
                 return;
             }
-            acquire_callable(other.callable);
-        }
 
-        AA_SBO_function(AA_SBO_function&& other) noexcept:
-            a_base(std::move(other)),
-            callable(std::exchange(other.callable, nullptr))
-        {
-            if (!other.callable) {
+            if (other.is_sbo_in_use() || get_allocator() == other.get_allocator()) {
+                invoker = std::exchange(other.invoker, nullptr);
+                operations() = std::exchange(other.operations(), nullptr);
+                relocate_storage(other);
                 return;
             }
-            acquire_callable(other.callable);
-        }
 
-        template<class Callable>
-        AA_SBO_function(const A& a, Callable&& callable):
-            a_base(a),
-            callable()
-        {
-            acquire_callable<Callable>(std::forward<Callable>(callable));
-        }
+            const operations_type& ops = *other.operations();
+            if (!ops.move_constructor_delegate) {
+                throw std::logic_error{"atul::AA_SBO_function: immovable callable cannot change allocators"};
+            }
 
-        template<class Callable>
-        explicit AA_SBO_function(Callable&& callable):
-            AA_SBO_function(A{}, std::forward<Callable>(callable)) {}
+            std::byte* target = allocate_storage(ops, false);
+            try {
+                ops.move_constructor_delegate(other.wrapper_address(), target);
+            } catch (...) {
+                deallocate_storage(target, ops);
+                throw;
+            }
 
-        template<class Callable>
-        AA_SBO_function(const allocator_type& a, Callable* callable):
-            a_base(a)
-        {
-            acquire_callable<Callable*>(callable);
+            invoker = other.invoker;
+            operations() = &ops;
+            store_pointer(target);
+            Observer::template on_acquire<AA_SBO_function>(false, ops.size_of);
+            other.release_callable();
         }
 
-        template<class Callable>
-        explicit AA_SBO_function(Callable* callable):
-            AA_SBO_function(allocator_type{}, callable) {}
+        template<class T>
+        void acquire_callable(T&& c) {
+            using Callable = std::decay_t<T>;
+            using Argument = std::remove_cv_t<std::remove_reference_t<T>>;
 
-        ~AA_SBO_function() {
-            release_callable();
+            if constexpr (std::is_pointer_v<Argument> || std::is_member_pointer_v<Argument>) {
+                if (c == nullptr) {
+                    return;
+                }
+            }
+
+            emplace_callable<Callable>(std::forward<T>(c));
         }
 
-        //=================================================
-        // Assignment operators
-        //=================================================
+        ///
+        /// Constructs a Callable from ctor_args in this object's storage,
+        /// which must be empty
+        ///
+        template<class Callable, class...Ctor_args>
+        Callable& emplace_callable(Ctor_args&&...ctor_args) {
+            using callable_type = typename signature_traits::template wrapper_type<Callable>;
+
+            static_assert(
+                std::is_same_v<Callable, std::decay_t<Callable>>,
+                "Callable must be a non-const, non-reference object type."
+            );
+            static_assert(
+                !Is_copyable || std::is_copy_constructible_v<Callable>,
+                "Copyable AA_SBO_function requires a copy constructible callable. Consider a move-only variant."
+            );
+            static_assert(
+                signature_traits::template is_compatible<Callable>,
+                "Callable cannot be invoked through the function's signature, or may throw from a noexcept signature."
+            );
+            static_assert(
+                alignof(callable_type) <= max_alignment,
+                "Callable is aligned more strictly than AA_SBO_function supports."
+            );
 
-        AA_SBO_function& operator=(const AA_SBO_function& rhs) noexcept {
-            if (this == &rhs) {
-                return *this;
-            }
+            constexpr bool use_sb = stores_inline<Callable>;
+            constexpr const operations_type& ops = signature_traits::template operations<Callable, use_sb>();
 
-            release_callable();
-            a_base::operator=(rhs);
+            std::byte* allocation = allocate_storage(ops, use_sb);
 
-            if (!rhs.callable) {
-                return *this;
+            auto* alloc = reinterpret_cast<callable_type*>(allocation);
+            if constexpr (use_sb) {
+                new (alloc) callable_type(std::in_place, std::forward<Ctor_args>(ctor_args)...);
+            } else {
+                try {
+                    new (alloc) callable_type(std::in_place, std::forward<Ctor_args>(ctor_args)...);
+                } catch (...) {
+                    deallocate_storage(allocation, ops);
+                    throw;
+                }
             }
 
-            auto allocator = a_base::get_allocator();
-            std::byte* target = allocator.allocate(rhs.callable->size_of());
-
-            rhs.callable->copy_constructor_delegate(target);
-            callable = reinterpret_cast<Callable_interface<Ret, Args...>*>(target);
+            invoker = signature_traits::invoker_of(ops);
+            operations() = &ops;
+            if constexpr (!use_sb) {
+                store_pointer(alloc);
+            }
+            Observer::template on_acquire<AA_SBO_function>(use_sb, use_sb ? 0 : ops.size_of);
 
-            return *this;
+            return std::launder(alloc)->callable;
         }
 
-        AA_SBO_function& operator=(AA_SBO_function&& rhs) noexcept {
-            if (this == &rhs) {
-                return *this;
+        void release_callable() {
+            if (!operations()) {
+                return;
             }
 
-            release_callable();
-            a_base::operator=(rhs);
+            const operations_type* ops = operations();
+            if (ops->is_trivial) {
+                Observer::template on_release<AA_SBO_function>(true, 0);
+                invoker = nullptr;
+                operations() = nullptr;
+                return;
+            }
 
-            if (!rhs.callable) {
-                return *this;
+            void* wrapper = wrapper_address();
+            ops->destroy(wrapper);
+            if (!ops->is_inline) {
+                deallocate_storage(static_cast<std::byte*>(wrapper), *ops);
             }
+            Observer::template on_release<AA_SBO_function>(ops->is_inline, ops->is_inline ? 0 : ops->size_of);
 
-            auto allocator = a_base::get_allocator();
-            std::byte* target = allocator.allocate(rhs.callable->size_of());
+            invoker = nullptr;
+            operations() = nullptr;
+        }
 
-            rhs.callable->move_constructor_delegate(target);
-            callable = reinterpret_cast<Callable_interface<Ret, Args...>*>(target);
+    };
 
-            return *this;
-        }
+    ///
+    /// Without a small buffer, an AA_SBO_function only ever holds a pointer
+    /// or a stateless callable, so it's trivially relocatable whenever its
+    /// allocator is. With one, it may hold callables which aren't.
+    ///
+    template<class A, std::size_t SB_size, class C, bool Is_copyable, class Observer, std::size_t Align>
+    struct is_trivially_relocatable<AA_SBO_function<A, SB_size, C, Is_copyable, Observer, Align>> : std::bool_constant<
+        SB_size == 0 &&
+        is_trivially_relocatable_v<typename std::allocator_traits<A>::template rebind_alloc<std::byte>>
+    > {};
+
+    template<class A, std::size_t SB_size, class C, bool Is_copyable, class Observer, std::size_t Align>
+    void swap(
+        AA_SBO_function<A, SB_size, C, Is_copyable, Observer, Align>& lhs,
+        AA_SBO_function<A, SB_size, C, Is_copyable, Observer, Align>& rhs
+    ) noexcept(noexcept(lhs.swap(rhs))) {
+        lhs.swap(rhs);
+    }
 
-        template<class C>
-        AA_SBO_function& operator=(C&& callable) {
-            release_callable();
-            this->callable = acquire_callable(callable);
-            return *this;
-        }
+    ///
+    /// True if function type F never allocates when constructed from a
+    /// Callable. Intended for use in static assertions which guard hot-path
+    /// callables against growing out of the small buffer.
+    ///
+    /// @tparam F AA_SBO_function instantiation
+    /// @tparam Callable Callable type
+    template<class F, class Callable>
+    inline constexpr bool stores_inline_v = F::template stores_inline<Callable>;
 
-        template<class C>
-        AA_SBO_function& operator=(std::reference_wrapper<C> callable) noexcept {
-            release_callable();
-            this->callable = acquire_callable(callable);
-            return *this;
-        }
+    //=====================================================
+    // Function_ref
+    //=====================================================
+
+    template<class C>
+    class Function_ref;
+
+    ///
+    /// A non-owning view of a callable object.
+    ///
+    /// Function_ref is two pointers wide, never allocates, and never copies
+    /// the callable it refers to. It is intended for callback parameters which
+    /// are only invoked for the duration of a single call. The referenced
+    /// callable must outlive the Function_ref.
+    ///
+    /// A Function_ref bound to a null function pointer or member pointer is
+    /// empty. It converts to false and throws std::bad_function_call when
+    /// invoked.
+    ///
+    /// @tparam Ret Callable return type
+    /// @tparam Args Callable argument types
+    template<class Ret, class...Args>
+    class Function_ref<Ret(Args...)> {
+
+        union Storage {
+            void* object;
+            void (*function)();
+        };
+
+        using invoker_type = Ret (*)(Storage, forwarded_parameter_t<Args>...);
+
+        template<class Callable>
+        static constexpr bool is_referenceable_v =
+            !std::is_same_v<std::decay_t<Callable>, Function_ref> &&
+            std::is_invocable_r_v<Ret, Callable&, Args...>;
+
+    public:
 
         //=================================================
-        // Accessors
+        // Type aliases
         //=================================================
 
-        [[nodiscard]]
-        explicit operator bool() const {
-            return callable == nullptr;
-        }
+        using return_type = Ret;
 
-        [[nodiscard]]
-        const std::type_info& target_type() const noexcept {
-            if (callable) {
-                return callable->target_type();
+        //=================================================
+        // -ctors
+        //=================================================
+
+        Function_ref() = delete;
+
+        Function_ref(const Function_ref&) noexcept = default;
+
+        Function_ref(Function_ref&&) noexcept = default;
+
+        template<class Callable, class = std::enable_if_t<is_referenceable_v<Callable>>>
+        Function_ref(Callable&& callable) noexcept {
+            using callable_type = std::remove_reference_t<Callable>;
+
+            if constexpr (std::is_function_v<callable_type>) {
+                storage.function = reinterpret_cast<void (*)()>(&callable);
+                invoker = &call_function<callable_type*>;
+            } else if constexpr (std::is_pointer_v<callable_type> && std::is_function_v<std::remove_pointer_t<callable_type>>) {
+                storage.function = reinterpret_cast<void (*)()>(callable);
+                invoker = callable ? &call_function<callable_type> : &call_empty;
+            } else if constexpr (std::is_member_pointer_v<std::remove_cv_t<callable_type>>) {
+                storage.object = const_cast<void*>(static_cast<const volatile void*>(std::addressof(callable)));
+                invoker = callable ? &call_object<callable_type> : &call_empty;
             } else {
-                return typeid(void);
+                storage.object = const_cast<void*>(static_cast<const volatile void*>(std::addressof(callable)));
+                invoker = &call_object<callable_type>;
             }
         }
 
-        template<class T>
+        ~Function_ref() = default;
+
+        //=================================================
+        // Assignment operators
+        //=================================================
+
+        Function_ref& operator=(const Function_ref&) noexcept = default;
+
+        Function_ref& operator=(Function_ref&&) noexcept = default;
+
+        //=================================================
+        // Accessors
+        //=================================================
+
         [[nodiscard]]
-        T* target() noexcept {
-            if  (typeid(T) == target_type() && callable) {
-                return reinterpret_cast<T*>(callable->target());
-            } else {
-                return nullptr;
-            }
+        explicit operator bool() const noexcept {
+            return invoker != &call_empty;
         }
 
         //=================================================
         // Misc.
         //=================================================
 
-        void swap(AA_SBO_function& other) noexcept {
-            a_base::swap(other);
-            std::swap(callable, other.callable);
+        void swap(Function_ref& other) noexcept {
+            std::swap(storage, other.storage);
+            std::swap(invoker, other.invoker);
         }
 
-        Ret operator()(Args&&...args) {
-            if (!callable) {
-                throw std::bad_function_call();
-            }
-
-            return callable->call(std::forward<Args>(args)...);
+        Ret operator()(Args...args) const {
+            return invoker(storage, std::forward<Args>(args)...);
         }
 
     private:
@@ -643,44 +1321,26 @@ namespace atul {
         // Instance members
         //=================================================
 
-        Callable_interface<Ret, Args...>* callable = nullptr;
+        Storage storage;
+
+        invoker_type invoker;
 
         //=================================================
         // Helper functions
         //=================================================
 
-        template<class Callable>
-        void acquire_callable(const Callable& c) {
-            auto allocator = a_base::get_allocator();
-            std::byte* allocation = allocator.allocate(sizeof(Callable_wrapper<Callable, Ret, Args...>));
-            if (allocation == nullptr) {
-                throw std::bad_alloc();
-            }
-
-            auto* callable_ptr = reinterpret_cast<Callable_wrapper<Callable, Ret, Args...>*>(allocation);
-            new (callable_ptr) Callable_wrapper<Callable, Ret, Args...>{c};
-            callable = callable_ptr;
+        template<class F>
+        static Ret call_function(Storage storage, forwarded_parameter_t<Args>...args) {
+            return std::invoke(reinterpret_cast<F>(storage.function), std::forward<Args>(args)...);
         }
 
         template<class Callable>
-        void acquire_callable(Callable&& c) {
-            auto allocator = a_base::get_allocator();
-            std::byte* allocation = allocator.allocate(sizeof(Callable_wrapper<Callable, Ret, Args...>));
-            if (allocation == nullptr) {
-                throw std::bad_alloc();
-            }
-
-            auto* callable_ptr = reinterpret_cast<Callable_wrapper<Callable, Ret, Args...>*>(allocation);
-            new (callable_ptr) Callable_wrapper<Callable, Ret, Args...>{std::forward<Callable>(c)};
-            callable = callable_ptr;
+        static Ret call_object(Storage storage, forwarded_parameter_t<Args>...args) {
+            return std::invoke(*static_cast<Callable*>(storage.object), std::forward<Args>(args)...);
         }
 
-        void release_callable() {
-            if (callable) {
-                callable->~Callable_interface();
-                auto allocator = a_base::get_allocator();
-                allocator.deallocate(reinterpret_cast<std::byte*>(callable), sizeof(*callable));
-            }
+        static Ret call_empty(Storage, forwarded_parameter_t<Args>...) {
+            throw std::bad_function_call();
         }
 
     };
@@ -698,6 +1358,52 @@ namespace atul {
     template<std::size_t SB_size, class C>
     using SBO_function = AA_SBO_function<std::allocator<std::byte>, SB_size, C>;
 
+    template<std::size_t SB_size, std::size_t Align, class C>
+    using Aligned_SBO_function = AA_SBO_function<std::allocator<std::byte>, SB_size, C, true, Default_function_observer, Align>;
+
+    template<class C>
+    using Arena_function = AA_SBO_function<Arena_allocator<std::byte>, 0, C>;
+
+    template<std::size_t SB_size, class C>
+    using Arena_SBO_function = AA_SBO_function<Arena_allocator<std::byte>, SB_size, C>;
+
+    template<class A, std::size_t SB_size, class C>
+    using AA_SBO_unique_function = AA_SBO_function<A, SB_size, C, false>;
+
+    template<class C>
+    using Unique_function = AA_SBO_function<std::allocator<std::byte>, 0, C, false>;
+
+    template<class A, class C>
+    using AA_unique_function = AA_SBO_function<A, 0, C, false>;
+
+    template<std::size_t SB_size, class C>
+    using SBO_unique_function = AA_SBO_function<std::allocator<std::byte>, SB_size, C, false>;
+
+    ///
+    /// Function wrappers whose memory resource is chosen at runtime. Objects
+    /// using different resources share a type, and std::pmr containers pass
+    /// their resource on to the functions they hold.
+    ///
+    /// std::pmr::polymorphic_allocator does not propagate on copy assignment,
+    /// move assignment or swap, so a function keeps the resource it was
+    /// constructed with.
+    ///
+    namespace pmr {
+
+        template<class C>
+        using Function = AA_SBO_function<std::pmr::polymorphic_allocator<std::byte>, 0, C>;
+
+        template<std::size_t SB_size, class C>
+        using SBO_function = AA_SBO_function<std::pmr::polymorphic_allocator<std::byte>, SB_size, C>;
+
+        template<class C>
+        using Unique_function = AA_SBO_function<std::pmr::polymorphic_allocator<std::byte>, 0, C, false>;
+
+        template<std::size_t SB_size, class C>
+        using SBO_unique_function = AA_SBO_function<std::pmr::polymorphic_allocator<std::byte>, SB_size, C, false>;
+
+    }
+
 }
 
 #endif //ATUL_FUNCTION_HPP
@@ -0,0 +1,150 @@
+#ifndef ATUL_FUNCTION_STATISTICS_HPP
+#define ATUL_FUNCTION_STATISTICS_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace atul {
+
+    //=====================================================
+    // Function_statistics
+    //=====================================================
+
+    ///
+    /// Counters describing how instances of a particular AA_SBO_function
+    /// instantiation store their callables.
+    ///
+    /// All counters are updated with relaxed atomic operations and are only
+    /// meant to be read as a snapshot.
+    ///
+    struct Function_statistics {
+
+        ///
+        /// Number of callables which were placed in the small buffer
+        ///
+        std::atomic<std::uint64_t> sbo_hits{0};
+
+        ///
+        /// Number of callables which were placed in allocated storage
+        ///
+        std::atomic<std::uint64_t> sbo_misses{0};
+
+        ///
+        /// Total number of bytes ever allocated for callables
+        ///
+        std::atomic<std::uint64_t> heap_bytes{0};
+
+        ///
+        /// Number of bytes currently allocated for callables
+        ///
+        std::atomic<std::uint64_t> live_heap_bytes{0};
+
+        ///
+        /// Number of callables currently held
+        ///
+        std::atomic<std::uint64_t> live_wrappers{0};
+
+        ///
+        /// Highest value live_wrappers has reached
+        ///
+        std::atomic<std::uint64_t> peak_live_wrappers{0};
+
+        void reset() noexcept {
+            sbo_hits.store(0, std::memory_order_relaxed);
+            sbo_misses.store(0, std::memory_order_relaxed);
+            heap_bytes.store(0, std::memory_order_relaxed);
+            live_heap_bytes.store(0, std::memory_order_relaxed);
+            live_wrappers.store(0, std::memory_order_relaxed);
+            peak_live_wrappers.store(0, std::memory_order_relaxed);
+        }
+
+    };
+
+    //=====================================================
+    // Observers
+    //=====================================================
+
+    ///
+    /// Observer which ignores all events. Calls to it compile to nothing.
+    ///
+    /// An observer is notified with the type of the observed function object
+    /// whenever a callable is placed in, or removed from, storage owned by a
+    /// function object. Moves which only transfer ownership of existing
+    /// storage are not reported.
+    ///
+    struct Null_function_observer {
+
+        template<class F>
+        static void on_acquire(bool is_inline, std::size_t heap_bytes) noexcept {
+            static_cast<void>(is_inline);
+            static_cast<void>(heap_bytes);
+        }
+
+        template<class F>
+        static void on_release(bool is_inline, std::size_t heap_bytes) noexcept {
+            static_cast<void>(is_inline);
+            static_cast<void>(heap_bytes);
+        }
+
+    };
+
+    ///
+    /// Observer which records events in a Function_statistics object
+    /// associated with each observed function type.
+    ///
+    struct Function_statistics_observer {
+
+        ///
+        /// @tparam F Observed function type
+        /// @return Statistics for function type F
+        template<class F>
+        [[nodiscard]]
+        static Function_statistics& statistics() noexcept {
+            static Function_statistics stats;
+            return stats;
+        }
+
+        template<class F>
+        static void on_acquire(bool is_inline, std::size_t heap_bytes) noexcept {
+            Function_statistics& stats = statistics<F>();
+
+            if (is_inline) {
+                stats.sbo_hits.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                stats.sbo_misses.fetch_add(1, std::memory_order_relaxed);
+                stats.heap_bytes.fetch_add(heap_bytes, std::memory_order_relaxed);
+                stats.live_heap_bytes.fetch_add(heap_bytes, std::memory_order_relaxed);
+            }
+
+            std::uint64_t live = stats.live_wrappers.fetch_add(1, std::memory_order_relaxed) + 1;
+            std::uint64_t peak = stats.peak_live_wrappers.load(std::memory_order_relaxed);
+            while (peak < live && !stats.peak_live_wrappers.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+        }
+
+        template<class F>
+        static void on_release(bool is_inline, std::size_t heap_bytes) noexcept {
+            Function_statistics& stats = statistics<F>();
+
+            if (!is_inline) {
+                stats.live_heap_bytes.fetch_sub(heap_bytes, std::memory_order_relaxed);
+            }
+
+            stats.live_wrappers.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+    };
+
+    ///
+    /// Observer used by AA_SBO_function when none is specified. Statistics
+    /// are only collected when ATUL_FUNCTION_STATISTICS is defined.
+    ///
+    #if defined(ATUL_FUNCTION_STATISTICS)
+    using Default_function_observer = Function_statistics_observer;
+    #else
+    using Default_function_observer = Null_function_observer;
+    #endif
+
+}
+
+#endif //ATUL_FUNCTION_STATISTICS_HPP
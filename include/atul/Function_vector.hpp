@@ -0,0 +1,371 @@
+#ifndef ATUL_FUNCTION_VECTOR_HPP
+#define ATUL_FUNCTION_VECTOR_HPP
+
+#include "Function.hpp"
+#include "Relocation.hpp"
+#include "Allocators.hpp"
+
+#include <aul/containers/Allocator_aware_base.hpp>
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include <typeinfo>
+#include <type_traits>
+#include <cstring>
+#include <cstddef>
+#include <new>
+
+namespace atul {
+
+    //=====================================================
+    // AA_function_vector
+    //=====================================================
+
+    template<class A, class C>
+    class AA_function_vector;
+
+    ///
+    /// A container of type-erased callables which stores callables of the
+    /// same concrete type contiguously, in groups.
+    ///
+    /// invoke_all() resolves a single function per group and calls every
+    /// callable in the group from a loop in which the callable's type is
+    /// statically known. This replaces one unpredictable indirect branch per
+    /// callable with one per group.
+    ///
+    /// Callables are invoked group by group, in order of each group's first
+    /// insertion, and in insertion order within a group. Insertion order
+    /// across groups is not preserved.
+    ///
+    /// @tparam A STL compatible allocator type
+    /// @tparam Ret Callable return type. Results are discarded
+    /// @tparam Args Callable argument types
+    template<class A, class Ret, class...Args>
+    class AA_function_vector<A, Ret(Args...)> : public aul::Allocator_aware_base<typename std::allocator_traits<A>::template rebind_alloc<std::byte>> {
+        using a_base = aul::Allocator_aware_base<typename std::allocator_traits<A>::template rebind_alloc<std::byte>>;
+
+        ///
+        /// Operations over a contiguous array of callables of one type
+        ///
+        struct Group_operations {
+            void (*invoke_all)(std::byte*, std::size_t, shared_parameter_t<Args>...);
+
+            void (*destroy_all)(std::byte*, std::size_t) noexcept;
+
+            void (*relocate_all)(std::byte*, std::size_t, std::byte*) noexcept;
+
+            std::size_t size_of;
+
+            const std::type_info& (*target_type)() noexcept;
+        };
+
+        template<class Callable>
+        struct Group_delegates {
+
+            static void invoke_all(std::byte* data, std::size_t n, shared_parameter_t<Args>...args) {
+                auto* callables = std::launder(reinterpret_cast<Callable*>(data));
+                for (std::size_t i = 0; i < n; ++i) {
+                    static_cast<void>(std::invoke(callables[i], args...));
+                }
+            }
+
+            static void destroy_all(std::byte* data, std::size_t n) noexcept {
+                auto* callables = std::launder(reinterpret_cast<Callable*>(data));
+                for (std::size_t i = 0; i < n; ++i) {
+                    callables[i].~Callable();
+                }
+            }
+
+            static void relocate_all(std::byte* data, std::size_t n, std::byte* dest) noexcept {
+                auto* callables = std::launder(reinterpret_cast<Callable*>(data));
+                uninitialized_relocate(callables, callables + n, reinterpret_cast<Callable*>(dest));
+            }
+
+            static const std::type_info& target_type() noexcept {
+                return typeid(Callable);
+            }
+
+        };
+
+        template<class Callable>
+        static constexpr Group_operations group_operations {
+            &Group_delegates<Callable>::invoke_all,
+            &Group_delegates<Callable>::destroy_all,
+            &Group_delegates<Callable>::relocate_all,
+            sizeof(Callable),
+            &Group_delegates<Callable>::target_type
+        };
+
+        struct Group {
+            const Group_operations* operations = nullptr;
+
+            std::byte* data = nullptr;
+
+            std::size_t size = 0;
+
+            std::size_t capacity = 0;
+        };
+
+        using group_allocator_type = typename std::allocator_traits<A>::template rebind_alloc<Group>;
+
+        static constexpr std::size_t initial_group_capacity = 8;
+
+        ///
+        /// Unit in which group storage is requested. Rebinding the allocator
+        /// to a max-aligned block type makes any allocator which honors
+        /// alignof(T) return storage suitable for every permitted callable.
+        ///
+        struct alignas(std::max_align_t) Storage_block {
+            std::byte bytes[alignof(std::max_align_t)];
+        };
+
+        using block_allocator_type = typename std::allocator_traits<A>::template rebind_alloc<Storage_block>;
+
+    public:
+
+        //=================================================
+        // Type aliases
+        //=================================================
+
+        using return_type = Ret;
+
+        using allocator_type = typename std::allocator_traits<A>::template rebind_alloc<std::byte>;
+
+        using size_type = std::size_t;
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        AA_function_vector() = default;
+
+        explicit AA_function_vector(const allocator_type& a):
+            a_base(a),
+            groups(group_allocator_type{a}) {}
+
+        AA_function_vector(const AA_function_vector&) = delete;
+
+        AA_function_vector(AA_function_vector&& other) noexcept:
+            a_base(std::move(other)),
+            groups(std::move(other.groups)),
+            element_count(std::exchange(other.element_count, 0)) {}
+
+        ~AA_function_vector() {
+            clear();
+        }
+
+        //=================================================
+        // Assignment operators
+        //=================================================
+
+        AA_function_vector& operator=(const AA_function_vector&) = delete;
+
+        AA_function_vector& operator=(AA_function_vector&& rhs) noexcept(
+            std::allocator_traits<allocator_type>::propagate_on_container_move_assignment::value ||
+            std::allocator_traits<allocator_type>::is_always_equal::value
+        ) {
+            if (this == &rhs) {
+                return *this;
+            }
+
+            clear();
+            a_base::operator=(std::move(rhs));
+
+            if (a_base::get_allocator() == rhs.get_allocator()) {
+                groups = std::move(rhs.groups);
+                element_count = std::exchange(rhs.element_count, 0);
+                return *this;
+            }
+
+            // Storage can't be adopted, so relocate each group into storage
+            // obtained from this container's allocator
+            for (Group& group : rhs.groups) {
+                const std::size_t size_of = group.operations->size_of;
+
+                Group& new_group = groups.emplace_back();
+                new_group.operations = group.operations;
+                new_group.data = allocate_storage(a_base::get_allocator(), group.size * size_of);
+                new_group.size = group.size;
+                new_group.capacity = group.size;
+
+                group.operations->relocate_all(group.data, group.size, new_group.data);
+                deallocate_storage(rhs.get_allocator(), group.data, group.capacity * size_of);
+            }
+
+            rhs.groups.clear();
+            element_count = std::exchange(rhs.element_count, 0);
+
+            return *this;
+        }
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        [[nodiscard]]
+        size_type size() const noexcept {
+            return element_count;
+        }
+
+        [[nodiscard]]
+        bool empty() const noexcept {
+            return element_count == 0;
+        }
+
+        ///
+        /// @return Number of distinct callable types held
+        [[nodiscard]]
+        size_type group_count() const noexcept {
+            return groups.size();
+        }
+
+        //=================================================
+        // Modifiers
+        //=================================================
+
+        ///
+        /// Appends a copy of, or moves, the specified callable into the group
+        /// for its type
+        ///
+        /// @param c Callable object
+        template<class C>
+        void push_back(C&& c) {
+            emplace<std::decay_t<C>>(std::forward<C>(c));
+        }
+
+        ///
+        /// Constructs a callable of type Callable in place at the end of the
+        /// group for its type
+        ///
+        /// @return Reference to newly constructed callable
+        template<class Callable, class...Ctor_args>
+        Callable& emplace(Ctor_args&&...ctor_args) {
+            static_assert(std::is_invocable_v<Callable&, Args&...>);
+            static_assert(std::is_nothrow_move_constructible_v<Callable>);
+            static_assert(alignof(Callable) <= alignof(std::max_align_t));
+
+            Group& group = find_or_create_group(group_operations<Callable>);
+            if (group.size == group.capacity) {
+                grow(group);
+            }
+
+            auto* ptr = new (group.data + group.size * sizeof(Callable)) Callable(std::forward<Ctor_args>(ctor_args)...);
+            ++group.size;
+            ++element_count;
+
+            return *ptr;
+        }
+
+        ///
+        /// Destroys all callables and releases all storage
+        ///
+        void clear() noexcept {
+            for (Group& group : groups) {
+                group.operations->destroy_all(group.data, group.size);
+                deallocate_storage(a_base::get_allocator(), group.data, group.capacity * group.operations->size_of);
+            }
+
+            groups.clear();
+            element_count = 0;
+        }
+
+        //=================================================
+        // Misc.
+        //=================================================
+
+        ///
+        /// Invokes every held callable with the specified arguments
+        ///
+        void invoke_all(Args...args) {
+            for (Group& group : groups) {
+                group.operations->invoke_all(group.data, group.size, args...);
+            }
+        }
+
+    private:
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        std::vector<Group, group_allocator_type> groups{};
+
+        size_type element_count = 0;
+
+        //=================================================
+        // Helper functions
+        //=================================================
+
+        ///
+        /// Finds the group for ops, creating it if there is none. A new group
+        /// is only added once its storage has been obtained, so a failed
+        /// allocation leaves no group without storage behind.
+        ///
+        [[nodiscard]]
+        Group& find_or_create_group(const Group_operations& ops) {
+            for (Group& group : groups) {
+                if (group.operations == &ops) {
+                    return group;
+                }
+            }
+
+            const std::size_t size = initial_group_capacity * ops.size_of;
+            std::byte* data = allocate_storage(a_base::get_allocator(), size);
+            try {
+                return groups.emplace_back(Group{&ops, data, 0, initial_group_capacity});
+            } catch (...) {
+                deallocate_storage(a_base::get_allocator(), data, size);
+                throw;
+            }
+        }
+
+        void grow(Group& group) {
+            const std::size_t new_capacity = group.capacity ? group.capacity * 2 : initial_group_capacity;
+            const std::size_t size_of = group.operations->size_of;
+
+            std::byte* new_data = allocate_storage(a_base::get_allocator(), new_capacity * size_of);
+
+            if (group.data) {
+                group.operations->relocate_all(group.data, group.size, new_data);
+                deallocate_storage(a_base::get_allocator(), group.data, group.capacity * size_of);
+            }
+
+            group.data = new_data;
+            group.capacity = new_capacity;
+        }
+
+        ///
+        /// Allocates max-aligned storage for size bytes through the allocator
+        /// rebound to the block type
+        ///
+        [[nodiscard]]
+        static std::byte* allocate_storage(const allocator_type& a, std::size_t size) {
+            block_allocator_type allocator{a};
+            auto* blocks = std::allocator_traits<block_allocator_type>::allocate(allocator, block_count(size));
+            return reinterpret_cast<std::byte*>(blocks);
+        }
+
+        static void deallocate_storage(const allocator_type& a, std::byte* data, std::size_t size) noexcept {
+            block_allocator_type allocator{a};
+            auto* blocks = reinterpret_cast<Storage_block*>(data);
+            std::allocator_traits<block_allocator_type>::deallocate(allocator, blocks, block_count(size));
+        }
+
+        [[nodiscard]]
+        static constexpr std::size_t block_count(std::size_t size) noexcept {
+            return (size + sizeof(Storage_block) - 1) / sizeof(Storage_block);
+        }
+
+    };
+
+    //=====================================================
+    // Convenience type aliases
+    //=====================================================
+
+    template<class C>
+    using Function_vector = AA_function_vector<std::allocator<std::byte>, C>;
+
+}
+
+#endif //ATUL_FUNCTION_VECTOR_HPP
@@ -0,0 +1,250 @@
+#ifndef ATUL_INPLACE_FUNCTION_HPP
+#define ATUL_INPLACE_FUNCTION_HPP
+
+#include "Function.hpp"
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <new>
+#include <cstddef>
+
+namespace atul {
+
+    //=====================================================
+    // Inplace_function
+    //=====================================================
+
+    template<std::size_t N, class C, bool Is_copyable = true>
+    class Inplace_function;
+
+    ///
+    /// A function wrapper which always stores its callable in an internal
+    /// buffer and has no means of allocating memory.
+    ///
+    /// Construction from a callable which does not fit in the buffer, or
+    /// which requires stricter alignment than a pointer, does not compile.
+    /// The object holds only a pointer to the callable's operations table
+    /// and the buffer itself.
+    ///
+    /// As in AA_SBO_function, callables which are not trivially relocatable
+    /// are moved through their move constructor, which must not throw, and a
+    /// null function pointer or member pointer produces an empty function.
+    ///
+    /// @tparam N Size of internal buffer. Rounded up to a multiple of the
+    /// size of a pointer
+    /// @tparam Is_copyable Whether the resulting type is copyable
+    /// @tparam Ret Callable return type
+    /// @tparam Args Callable argument types
+    template<std::size_t N, bool Is_copyable, class Ret, class...Args>
+    class Inplace_function<N, Ret(Args...), Is_copyable> {
+
+        using operations_type = Callable_operations<Ret, Args...>;
+
+        struct Deleted_copy {};
+
+        using copy_source_type = std::conditional_t<Is_copyable, Inplace_function, Deleted_copy>;
+
+    public:
+
+        //=================================================
+        // Constants
+        //=================================================
+
+        static constexpr std::size_t buffer_size = compute_sbo_size(std::max(N, sizeof(void*)), alignof(void*));
+
+        static constexpr std::size_t buffer_alignment = alignof(void*);
+
+        ///
+        /// Whether a callable of type Callable may be stored
+        ///
+        template<class Callable>
+        static constexpr bool fits =
+            sizeof(Callable_wrapper<std::decay_t<Callable>, Ret, Args...>) <= buffer_size &&
+            alignof(Callable_wrapper<std::decay_t<Callable>, Ret, Args...>) <= buffer_alignment;
+
+    private:
+
+        template<class Callable>
+        static constexpr bool is_storable_v =
+            !std::is_same_v<std::decay_t<Callable>, Inplace_function> &&
+            !std::is_same_v<std::decay_t<Callable>, std::nullptr_t> &&
+            fits<Callable> &&
+            std::is_nothrow_move_constructible_v<std::decay_t<Callable>> &&
+            (!Is_copyable || std::is_copy_constructible_v<std::decay_t<Callable>>);
+
+    public:
+
+        //=================================================
+        // Type aliases
+        //=================================================
+
+        using return_type = Ret;
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        Inplace_function() noexcept = default;
+
+        explicit Inplace_function(std::nullptr_t) noexcept {}
+
+        Inplace_function(const copy_source_type& other) {
+            if (other.operations) {
+                other.operations->copy_constructor_delegate(other.buffer, buffer);
+                operations = other.operations;
+            }
+        }
+
+        Inplace_function(Inplace_function&& other) noexcept {
+            take(other);
+        }
+
+        template<class Callable, class = std::enable_if_t<is_storable_v<Callable>>>
+        explicit Inplace_function(Callable&& callable) {
+            emplace(std::forward<Callable>(callable));
+        }
+
+        ~Inplace_function() {
+            reset();
+        }
+
+        //=================================================
+        // Assignment operators
+        //=================================================
+
+        Inplace_function& operator=(const copy_source_type& rhs) {
+            if (this != &rhs) {
+                Inplace_function tmp{rhs};
+                reset();
+                take(tmp);
+            }
+
+            return *this;
+        }
+
+        Inplace_function& operator=(Inplace_function&& rhs) noexcept {
+            if (this != &rhs) {
+                reset();
+                take(rhs);
+            }
+
+            return *this;
+        }
+
+        template<class Callable, class = std::enable_if_t<is_storable_v<Callable>>>
+        Inplace_function& operator=(Callable&& callable) {
+            reset();
+            emplace(std::forward<Callable>(callable));
+            return *this;
+        }
+
+        Inplace_function& operator=(std::nullptr_t) noexcept {
+            reset();
+            return *this;
+        }
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        [[nodiscard]]
+        explicit operator bool() const noexcept {
+            return operations != nullptr;
+        }
+
+        [[nodiscard]]
+        const std::type_info& target_type() const noexcept {
+            return operations ? operations->target_type() : typeid(void);
+        }
+
+        template<class T>
+        [[nodiscard]]
+        T* target() noexcept {
+            if (operations && typeid(T) == target_type()) {
+                return reinterpret_cast<T*>(operations->target(buffer));
+            } else {
+                return nullptr;
+            }
+        }
+
+        //=================================================
+        // Misc.
+        //=================================================
+
+        void swap(Inplace_function& other) noexcept {
+            Inplace_function tmp{std::move(other)};
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+
+        Ret operator()(Args...args) {
+            if (!operations) {
+                throw std::bad_function_call();
+            }
+
+            return operations->invoke(buffer, std::forward<Args>(args)...);
+        }
+
+    private:
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        const operations_type* operations = nullptr;
+
+        alignas(buffer_alignment) std::byte buffer[buffer_size] {};
+
+        //=================================================
+        // Helper functions
+        //=================================================
+
+        template<class C>
+        void emplace(C&& c) {
+            using Callable = std::decay_t<C>;
+            using Argument = std::remove_cv_t<std::remove_reference_t<C>>;
+
+            if constexpr (std::is_pointer_v<Argument> || std::is_member_pointer_v<Argument>) {
+                if (c == nullptr) {
+                    return;
+                }
+            }
+
+            new (buffer) Callable_wrapper<Callable, Ret, Args...>(std::forward<C>(c));
+            operations = &callable_operations<Callable, true, Ret, Args...>;
+        }
+
+        ///
+        /// Moves the callable held by other into this object's empty buffer
+        /// and leaves other empty
+        ///
+        void take(Inplace_function& other) noexcept {
+            if (!other.operations) {
+                return;
+            }
+
+            other.operations->move_constructor_delegate(other.buffer, buffer);
+            operations = other.operations;
+            other.reset();
+        }
+
+        void reset() noexcept {
+            if (operations) {
+                operations->destroy(buffer);
+                operations = nullptr;
+            }
+        }
+
+    };
+
+    //=====================================================
+    // Convenience type aliases
+    //=====================================================
+
+    template<std::size_t N, class C>
+    using Inplace_unique_function = Inplace_function<N, C, false>;
+
+}
+
+#endif //ATUL_INPLACE_FUNCTION_HPP
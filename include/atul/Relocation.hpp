@@ -0,0 +1,65 @@
+#ifndef ATUL_RELOCATION_HPP
+#define ATUL_RELOCATION_HPP
+
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+#include <cstring>
+#include <new>
+
+namespace atul {
+
+    ///
+    /// Trait indicating whether objects of type T may be relocated, that is,
+    /// moved to a new address with the original ceasing to exist, by copying
+    /// their object representation and not running the original's destructor.
+    ///
+    /// All trivially copyable types qualify. Users may specialize this trait
+    /// for their own types.
+    ///
+    /// @tparam T Object type
+    template<class T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+    template<class T>
+    struct is_trivially_relocatable<std::allocator<T>> : std::true_type {};
+
+    template<class T>
+    struct is_trivially_relocatable<std::pmr::polymorphic_allocator<T>> : std::true_type {};
+
+    template<class T>
+    inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+    ///
+    /// Relocates the objects in [first, last) into the uninitialized storage
+    /// beginning at dest. The source range is left without live objects. The
+    /// two ranges may not overlap.
+    ///
+    /// Trivially relocatable types are relocated with a single memcpy.
+    ///
+    /// @tparam T Object type
+    /// @param first Pointer to beginning of source range
+    /// @param last Pointer to end of source range
+    /// @param dest Pointer to beginning of destination storage
+    /// @return Pointer to end of destination range
+    template<class T>
+    T* uninitialized_relocate(T* first, T* last, T* dest) noexcept(is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T>) {
+        if constexpr (is_trivially_relocatable_v<T>) {
+            const auto n = static_cast<std::size_t>(last - first);
+            if (n != 0) {
+                std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first), n * sizeof(T));
+            }
+            return dest + n;
+        } else {
+            for (; first != last; ++first, ++dest) {
+                ::new (static_cast<void*>(dest)) T(std::move(*first));
+                first->~T();
+            }
+            return dest;
+        }
+    }
+
+}
+
+#endif //ATUL_RELOCATION_HPP
@@ -0,0 +1,542 @@
+#ifndef ATUL_SIGNAL_HPP
+#define ATUL_SIGNAL_HPP
+
+#include "Function.hpp"
+
+#include <aul/containers/Allocator_aware_base.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+namespace atul {
+
+    //=====================================================
+    // Connection
+    //=====================================================
+
+    ///
+    /// Handle to a slot connected to a signal. A handle whose slot has been
+    /// disconnected is detected through its generation and never refers to
+    /// a slot connected later in the same position. A default-constructed
+    /// handle refers to no slot, since generations start at 1.
+    ///
+    struct Connection {
+        std::uint32_t index = 0;
+
+        std::uint32_t generation = 0;
+    };
+
+    //=====================================================
+    // AA_SBO_signal
+    //=====================================================
+
+    template<class A, std::size_t SB_size, class C>
+    class AA_SBO_signal;
+
+    ///
+    /// A signal which invokes a set of connected slots when emitted.
+    ///
+    /// Slots are stored as a structure of arrays. The invokers of all slots
+    /// live in one contiguous array and their callables' state in another, so
+    /// emission walks memory linearly. Callables are stored inline in
+    /// fixed-size state cells when they fit, per the same rules as
+    /// AA_SBO_function, and are otherwise placed in allocated storage.
+    ///
+    /// Slots are held in chunks of geometrically increasing size which are
+    /// never moved once allocated.
+    ///
+    /// Thread safety: connect() and disconnect() may be called from any
+    /// thread and are serialized by an internal mutex. emit() takes no locks
+    /// and may run concurrently with itself and with connect() and
+    /// disconnect(). A slot disconnected during an emission may still be
+    /// invoked by that emission. Its callable is destroyed once no emissions
+    /// are in flight.
+    ///
+    /// @tparam A STL compatible allocator type
+    /// @tparam SB_size Size of each slot's inline state cell
+    /// @tparam Args Slot argument types
+    template<class A, std::size_t SB_size, class...Args>
+    class AA_SBO_signal<A, SB_size, void(Args...)> : public aul::Allocator_aware_base<typename std::allocator_traits<A>::template rebind_alloc<std::byte>> {
+        using a_base = aul::Allocator_aware_base<typename std::allocator_traits<A>::template rebind_alloc<std::byte>>;
+
+        using operations_type = Callable_operations<void, Args...>;
+
+        using invoker_type = typename operations_type::invoker_type;
+
+    public:
+
+        //=================================================
+        // Constants
+        //=================================================
+
+        static constexpr std::size_t state_size = std::max(compute_sbo_size(SB_size, alignof(void*)), sizeof(void*));
+
+        static constexpr std::size_t state_alignment = alignof(void*);
+
+        ///
+        /// Number of slots in the first chunk. Each subsequent chunk is twice
+        /// as large as the previous.
+        ///
+        static constexpr std::size_t base_chunk_size = 64;
+
+        static constexpr std::size_t max_chunks = 24;
+
+        //=================================================
+        // Type aliases
+        //=================================================
+
+        using allocator_type = typename std::allocator_traits<A>::template rebind_alloc<std::byte>;
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        AA_SBO_signal() = default;
+
+        explicit AA_SBO_signal(const allocator_type& a):
+            a_base(a),
+            free_indices(index_allocator_type{a}),
+            retired_indices(index_allocator_type{a}) {}
+
+        AA_SBO_signal(const AA_SBO_signal&) = delete;
+
+        AA_SBO_signal(AA_SBO_signal&&) = delete;
+
+        ~AA_SBO_signal() {
+            const std::size_t count = slot_count.load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i < count; ++i) {
+                Slot_ref slot = slot_at(i);
+                if (*slot.operations) {
+                    destroy_state(slot);
+                }
+            }
+
+            for (std::size_t k = 0; k < max_chunks; ++k) {
+                std::byte* chunk = chunks[k].load(std::memory_order_relaxed);
+                if (!chunk) {
+                    break;
+                }
+
+                deallocate_blocks(chunk, chunk_allocation_size(k), chunk_alignment);
+            }
+        }
+
+        //=================================================
+        // Assignment operators
+        //=================================================
+
+        AA_SBO_signal& operator=(const AA_SBO_signal&) = delete;
+
+        AA_SBO_signal& operator=(AA_SBO_signal&&) = delete;
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        ///
+        /// @param connection Connection handle
+        /// @return True if the handle refers to a currently connected slot
+        [[nodiscard]]
+        bool connected(Connection connection) const {
+            std::lock_guard<std::mutex> lock{writer_mutex};
+            if (connection.index >= slot_count.load(std::memory_order_relaxed)) {
+                return false;
+            }
+
+            return *slot_at(connection.index).generation == connection.generation;
+        }
+
+        ///
+        /// @return Number of currently connected slots
+        [[nodiscard]]
+        std::size_t size() const {
+            std::lock_guard<std::mutex> lock{writer_mutex};
+            return connection_count;
+        }
+
+        //=================================================
+        // Modifiers
+        //=================================================
+
+        ///
+        /// Connects a callable to this signal
+        ///
+        /// @param c Callable object
+        /// @return Handle which may be used to disconnect the callable
+        template<class C>
+        Connection connect(C&& c) {
+            using Callable = std::decay_t<C>;
+            using callable_type = Callable_wrapper<Callable, void, Args...>;
+            static_assert(
+                alignof(callable_type) <= max_alignment,
+                "Callable is aligned more strictly than AA_SBO_signal supports."
+            );
+
+            constexpr bool use_sb = fits_in_small_buffer<Callable, void, Args...>(state_size, state_alignment);
+            constexpr const operations_type& ops = callable_operations<Callable, use_sb, void, Args...>;
+
+            std::lock_guard<std::mutex> lock{writer_mutex};
+            reclaim_retired();
+
+            const std::uint32_t index = acquire_index();
+            Slot_ref slot = slot_at(index);
+
+            try {
+                if constexpr (use_sb) {
+                    new (slot.state) callable_type(std::forward<C>(c));
+                } else {
+                    std::byte* allocation = allocate_blocks(sizeof(callable_type), alignof(callable_type));
+                    try {
+                        new (allocation) callable_type(std::forward<C>(c));
+                    } catch (...) {
+                        deallocate_blocks(allocation, sizeof(callable_type), alignof(callable_type));
+                        throw;
+                    }
+                    new (slot.state) void*{allocation};
+                }
+            } catch (...) {
+                free_indices.push_back(index);
+                throw;
+            }
+
+            *slot.operations = &ops;
+            slot.invoker->store(ops.invoke, std::memory_order_release);
+            ++connection_count;
+
+            return Connection{index, *slot.generation};
+        }
+
+        ///
+        /// Disconnects the slot referred to by connection. Has no effect if
+        /// the slot was already disconnected.
+        ///
+        /// @param connection Handle returned by connect()
+        /// @return True if a slot was disconnected
+        bool disconnect(Connection connection) {
+            std::lock_guard<std::mutex> lock{writer_mutex};
+            if (connection.index >= slot_count.load(std::memory_order_relaxed)) {
+                return false;
+            }
+
+            Slot_ref slot = slot_at(connection.index);
+            if (*slot.generation != connection.generation) {
+                return false;
+            }
+
+            slot.invoker->store(nullptr, std::memory_order_seq_cst);
+            if (++*slot.generation == 0) {
+                *slot.generation = 1;
+            }
+            --connection_count;
+
+            retired_indices.push_back(connection.index);
+            reclaim_retired();
+
+            return true;
+        }
+
+        //=================================================
+        // Misc.
+        //=================================================
+
+        ///
+        /// Invokes all connected slots with the specified arguments
+        ///
+        void emit(Args...args) {
+            active_emissions.fetch_add(1, std::memory_order_seq_cst);
+
+            // Ends the emission even if a slot throws, so that retired slots
+            // are still reclaimed afterwards
+            struct Emission_end {
+                std::atomic<std::size_t>& active_emissions;
+
+                ~Emission_end() {
+                    active_emissions.fetch_sub(1, std::memory_order_release);
+                }
+            } emission_end{active_emissions};
+
+            std::size_t remaining = slot_count.load(std::memory_order_acquire);
+            for (std::size_t k = 0; k < max_chunks && remaining != 0; ++k) {
+                std::byte* chunk = chunks[k].load(std::memory_order_acquire);
+                const std::size_t n = std::min(remaining, chunk_size(k));
+
+                auto* invokers = chunk_invokers(chunk);
+                std::byte* states = chunk_states(chunk, k);
+                for (std::size_t i = 0; i < n; ++i) {
+                    invoker_type invoker = invokers[i].load(std::memory_order_seq_cst);
+                    if (invoker) {
+                        invoker(states + i * state_size, pass_to_slot<Args>(args)...);
+                    }
+                }
+
+                remaining -= n;
+            }
+        }
+
+        void operator()(Args...args) {
+            emit(std::forward<Args>(args)...);
+        }
+
+    private:
+
+        using index_allocator_type = typename std::allocator_traits<A>::template rebind_alloc<std::uint32_t>;
+
+        ///
+        /// Unit in which chunks and out-of-line callables are allocated.
+        /// Rebinding the allocator to a sufficiently aligned block type makes
+        /// any allocator which honors alignof(T) return suitable storage.
+        ///
+        template<std::size_t Alignment>
+        struct alignas(Alignment) Storage_block {
+            std::byte bytes[Alignment];
+        };
+
+        template<std::size_t Alignment>
+        using block_allocator_type = typename std::allocator_traits<A>::template rebind_alloc<Storage_block<Alignment>>;
+
+        static constexpr std::size_t max_alignment = 256;
+
+        static constexpr std::size_t chunk_alignment = alignof(std::max_align_t);
+
+        ///
+        /// Pointers to the elements of each array which describe one slot
+        ///
+        struct Slot_ref {
+            std::atomic<invoker_type>* invoker;
+
+            const operations_type** operations;
+
+            std::uint32_t* generation;
+
+            std::byte* state;
+        };
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        std::atomic<std::byte*> chunks[max_chunks]{};
+
+        ///
+        /// Number of slot positions which have ever been used
+        ///
+        std::atomic<std::size_t> slot_count{0};
+
+        std::atomic<std::size_t> active_emissions{0};
+
+        mutable std::mutex writer_mutex{};
+
+        std::size_t connection_count = 0;
+
+        ///
+        /// Indices of slots which may be reused
+        ///
+        std::vector<std::uint32_t, index_allocator_type> free_indices{};
+
+        ///
+        /// Indices of disconnected slots whose callables are yet to be
+        /// destroyed
+        ///
+        std::vector<std::uint32_t, index_allocator_type> retired_indices{};
+
+        //=================================================
+        // Chunk layout
+        //=================================================
+
+        [[nodiscard]]
+        static constexpr std::size_t chunk_size(std::size_t k) {
+            return base_chunk_size << k;
+        }
+
+        [[nodiscard]]
+        static constexpr std::size_t chunk_operations_offset(std::size_t k) {
+            return chunk_size(k) * sizeof(std::atomic<invoker_type>);
+        }
+
+        [[nodiscard]]
+        static constexpr std::size_t chunk_generations_offset(std::size_t k) {
+            return chunk_operations_offset(k) + chunk_size(k) * sizeof(const operations_type*);
+        }
+
+        [[nodiscard]]
+        static constexpr std::size_t chunk_states_offset(std::size_t k) {
+            return compute_sbo_size(chunk_generations_offset(k) + chunk_size(k) * sizeof(std::uint32_t), state_alignment);
+        }
+
+        [[nodiscard]]
+        static constexpr std::size_t chunk_allocation_size(std::size_t k) {
+            return chunk_states_offset(k) + chunk_size(k) * state_size;
+        }
+
+        [[nodiscard]]
+        static std::atomic<invoker_type>* chunk_invokers(std::byte* chunk) {
+            return std::launder(reinterpret_cast<std::atomic<invoker_type>*>(chunk));
+        }
+
+        [[nodiscard]]
+        static std::byte* chunk_states(std::byte* chunk, std::size_t k) {
+            return chunk + chunk_states_offset(k);
+        }
+
+        [[nodiscard]]
+        Slot_ref slot_at(std::size_t index) const {
+            std::size_t k = 0;
+            while (index >= chunk_size(k)) {
+                index -= chunk_size(k);
+                ++k;
+            }
+
+            std::byte* chunk = chunks[k].load(std::memory_order_relaxed);
+            return Slot_ref{
+                chunk_invokers(chunk) + index,
+                std::launder(reinterpret_cast<const operations_type**>(chunk + chunk_operations_offset(k))) + index,
+                std::launder(reinterpret_cast<std::uint32_t*>(chunk + chunk_generations_offset(k))) + index,
+                chunk_states(chunk, k) + index * state_size
+            };
+        }
+
+        //=================================================
+        // Helper functions
+        //=================================================
+
+        ///
+        /// Each slot receives its own copy of an argument, since a slot may
+        /// move from it. Arguments declared as lvalue references are handed
+        /// over directly.
+        ///
+        template<class T>
+        [[nodiscard]]
+        static std::conditional_t<std::is_lvalue_reference_v<T>, T, std::decay_t<T>> pass_to_slot(std::remove_reference_t<T>& arg) {
+            return arg;
+        }
+
+        [[nodiscard]]
+        std::uint32_t acquire_index() {
+            if (!free_indices.empty()) {
+                std::uint32_t index = free_indices.back();
+                free_indices.pop_back();
+                return index;
+            }
+
+            const std::size_t index = slot_count.load(std::memory_order_relaxed);
+
+            std::size_t k = 0;
+            std::size_t first = 0;
+            while (index >= first + chunk_size(k)) {
+                first += chunk_size(k);
+                ++k;
+            }
+
+            if (k == max_chunks) {
+                throw std::length_error{"atul::AA_SBO_signal: too many slots"};
+            }
+
+            if (index == first) {
+                allocate_chunk(k);
+            }
+
+            slot_count.store(index + 1, std::memory_order_release);
+            return static_cast<std::uint32_t>(index);
+        }
+
+        void allocate_chunk(std::size_t k) {
+            std::byte* chunk = allocate_blocks(chunk_allocation_size(k), chunk_alignment);
+
+            auto* invokers = chunk_invokers(chunk);
+            auto* operations = reinterpret_cast<const operations_type**>(chunk + chunk_operations_offset(k));
+            auto* generations = reinterpret_cast<std::uint32_t*>(chunk + chunk_generations_offset(k));
+            for (std::size_t i = 0; i < chunk_size(k); ++i) {
+                new (invokers + i) std::atomic<invoker_type>{nullptr};
+                new (operations + i) const operations_type*{nullptr};
+                new (generations + i) std::uint32_t{1};
+            }
+
+            chunks[k].store(chunk, std::memory_order_release);
+        }
+
+        void destroy_state(Slot_ref slot) {
+            const operations_type* ops = *slot.operations;
+            if (ops->is_inline) {
+                ops->destroy(slot.state);
+            } else {
+                void* wrapper = *std::launder(reinterpret_cast<void**>(slot.state));
+                ops->destroy(wrapper);
+
+                if constexpr (!is_deallocation_noop_v<allocator_type>) {
+                    deallocate_blocks(static_cast<std::byte*>(wrapper), ops->size_of, ops->align_of);
+                }
+            }
+
+            *slot.operations = nullptr;
+        }
+
+        ///
+        /// Allocates storage for size bytes through the allocator rebound to
+        /// the least aligned block type which satisfies alignment
+        ///
+        template<std::size_t Alignment = alignof(void*)>
+        [[nodiscard]]
+        std::byte* allocate_blocks(std::size_t size, std::size_t alignment) {
+            if constexpr (Alignment < max_alignment) {
+                if (Alignment < alignment) {
+                    return allocate_blocks<Alignment * 2>(size, alignment);
+                }
+            }
+
+            block_allocator_type<Alignment> allocator{a_base::get_allocator()};
+            auto* blocks = std::allocator_traits<block_allocator_type<Alignment>>::allocate(allocator, (size + Alignment - 1) / Alignment);
+            return reinterpret_cast<std::byte*>(blocks);
+        }
+
+        template<std::size_t Alignment = alignof(void*)>
+        void deallocate_blocks(std::byte* allocation, std::size_t size, std::size_t alignment) noexcept {
+            if constexpr (Alignment < max_alignment) {
+                if (Alignment < alignment) {
+                    deallocate_blocks<Alignment * 2>(allocation, size, alignment);
+                    return;
+                }
+            }
+
+            block_allocator_type<Alignment> allocator{a_base::get_allocator()};
+            auto* blocks = reinterpret_cast<Storage_block<Alignment>*>(allocation);
+            std::allocator_traits<block_allocator_type<Alignment>>::deallocate(allocator, blocks, (size + Alignment - 1) / Alignment);
+        }
+
+        ///
+        /// Destroys the callables of disconnected slots and makes their
+        /// positions available for reuse, provided no emission is in flight
+        ///
+        void reclaim_retired() {
+            if (retired_indices.empty() || active_emissions.load(std::memory_order_seq_cst) != 0) {
+                return;
+            }
+
+            for (std::uint32_t index : retired_indices) {
+                destroy_state(slot_at(index));
+                free_indices.push_back(index);
+            }
+
+            retired_indices.clear();
+        }
+
+    };
+
+    //=====================================================
+    // Convenience type aliases
+    //=====================================================
+
+    template<class C>
+    using Signal = AA_SBO_signal<std::allocator<std::byte>, 32, C>;
+
+    template<std::size_t SB_size, class C>
+    using SBO_signal = AA_SBO_signal<std::allocator<std::byte>, SB_size, C>;
+
+}
+
+#endif //ATUL_SIGNAL_HPP
@@ -0,0 +1,272 @@
+#ifndef ATUL_TASK_QUEUE_HPP
+#define ATUL_TASK_QUEUE_HPP
+
+#include "Function.hpp"
+
+#include <aul/containers/Allocator_aware_base.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace atul {
+
+    //=====================================================
+    // AA_SBO_task_queue
+    //=====================================================
+
+    template<class A, std::size_t SB_size, class C>
+    class AA_SBO_task_queue;
+
+    ///
+    /// A bounded, lock-free, multi-producer multi-consumer queue of tasks.
+    ///
+    /// Each slot of the ring buffer holds an AA_SBO_unique_function which is
+    /// constructed in place by try_push() and relocated out by
+    /// try_pop_invoke(). A task which fits in the small buffer therefore
+    /// passes between threads without any allocation.
+    ///
+    /// Every slot carries a sequence number which tells producers and
+    /// consumers whether it is free or holds a task for a particular lap
+    /// around the ring. Positions are claimed with a compare-and-swap on a
+    /// shared counter. A slot's contents are published by a release store of
+    /// its sequence number, which the other side observes with an acquire
+    /// load.
+    ///
+    /// @tparam A STL compatible allocator type
+    /// @tparam SB_size Size of each task's small buffer
+    /// @tparam Args Task argument types
+    template<class A, std::size_t SB_size, class...Args>
+    class AA_SBO_task_queue<A, SB_size, void(Args...)> : public aul::Allocator_aware_base<typename std::allocator_traits<A>::template rebind_alloc<std::byte>> {
+        using a_base = aul::Allocator_aware_base<typename std::allocator_traits<A>::template rebind_alloc<std::byte>>;
+
+    public:
+
+        //=================================================
+        // Type aliases
+        //=================================================
+
+        using allocator_type = typename std::allocator_traits<A>::template rebind_alloc<std::byte>;
+
+        using function_type = AA_SBO_unique_function<allocator_type, SB_size, void(Args...)>;
+
+        using size_type = std::size_t;
+
+        //=================================================
+        // Constants
+        //=================================================
+
+        static constexpr std::size_t cache_line_size = 64;
+
+    private:
+
+        struct Cell {
+            std::atomic<std::size_t> sequence;
+
+            alignas(function_type) std::byte task[sizeof(function_type)];
+        };
+
+        using cell_allocator_type = typename std::allocator_traits<A>::template rebind_alloc<Cell>;
+
+    public:
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        ///
+        /// @param capacity Minimum number of tasks the queue can hold. Rounded
+        /// up to a power of two
+        /// @param a Allocator used for the ring buffer and for tasks which
+        /// don't fit in the small buffer
+        explicit AA_SBO_task_queue(size_type capacity, const allocator_type& a = {}):
+            a_base(a),
+            mask(round_up_to_power_of_two(capacity) - 1)
+        {
+            cell_allocator_type allocator{a_base::get_allocator()};
+            cells = std::allocator_traits<cell_allocator_type>::allocate(allocator, mask + 1);
+
+            for (std::size_t i = 0; i <= mask; ++i) {
+                new (&cells[i].sequence) std::atomic<std::size_t>{i};
+            }
+        }
+
+        AA_SBO_task_queue(const AA_SBO_task_queue&) = delete;
+
+        AA_SBO_task_queue(AA_SBO_task_queue&&) = delete;
+
+        ~AA_SBO_task_queue() {
+            const std::size_t last = enqueue_position.load(std::memory_order_relaxed);
+            for (std::size_t pos = dequeue_position.load(std::memory_order_relaxed); pos != last; ++pos) {
+                stored_task(cells[pos & mask])->~function_type();
+            }
+
+            cell_allocator_type allocator{a_base::get_allocator()};
+            std::allocator_traits<cell_allocator_type>::deallocate(allocator, cells, mask + 1);
+        }
+
+        //=================================================
+        // Assignment operators
+        //=================================================
+
+        AA_SBO_task_queue& operator=(const AA_SBO_task_queue&) = delete;
+
+        AA_SBO_task_queue& operator=(AA_SBO_task_queue&&) = delete;
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        [[nodiscard]]
+        size_type capacity() const noexcept {
+            return mask + 1;
+        }
+
+        ///
+        /// @return True if no task was enqueued and not yet dequeued at some
+        /// point during the call
+        [[nodiscard]]
+        bool empty() const noexcept {
+            const std::size_t first = dequeue_position.load(std::memory_order_seq_cst);
+            return enqueue_position.load(std::memory_order_seq_cst) == first;
+        }
+
+        //=================================================
+        // Modifiers
+        //=================================================
+
+        ///
+        /// Constructs a task from c in the next free slot
+        ///
+        /// If the queue is full, c is left untouched. If constructing the task
+        /// throws, the slot is published empty and is skipped by consumers.
+        ///
+        /// An rvalue function_type, or the copyable function of the same
+        /// allocator, size and signature, is moved into the slot rather than
+        /// wrapped, so an inline callable stays inline.
+        ///
+        /// @param c Callable object or function_type
+        /// @return True if the task was enqueued. False if the queue was full
+        template<class C>
+        bool try_push(C&& c) {
+            std::size_t pos = enqueue_position.load(std::memory_order_relaxed);
+            Cell* cell = nullptr;
+            while (true) {
+                cell = &cells[pos & mask];
+                const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<std::ptrdiff_t>(sequence - pos);
+
+                if (difference == 0) {
+                    if (enqueue_position.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (difference < 0) {
+                    return false;
+                } else {
+                    pos = enqueue_position.load(std::memory_order_relaxed);
+                }
+            }
+
+            try {
+                if constexpr (std::is_convertible_v<C, function_type>) {
+                    new (cell->task) function_type(std::forward<C>(c));
+                } else {
+                    new (cell->task) function_type(a_base::get_allocator(), std::forward<C>(c));
+                }
+            } catch (...) {
+                new (cell->task) function_type{};
+                cell->sequence.store(pos + 1, std::memory_order_release);
+                throw;
+            }
+
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        ///
+        /// Removes the oldest task from the queue and invokes it. The slot is
+        /// released before the task runs.
+        ///
+        /// @return True if a task was invoked. False if the queue was empty
+        bool try_pop_invoke(Args...args) {
+            while (true) {
+                std::size_t pos = dequeue_position.load(std::memory_order_relaxed);
+                Cell* cell = nullptr;
+                while (true) {
+                    cell = &cells[pos & mask];
+                    const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                    const auto difference = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+
+                    if (difference == 0) {
+                        if (dequeue_position.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                            break;
+                        }
+                    } else if (difference < 0) {
+                        return false;
+                    } else {
+                        pos = dequeue_position.load(std::memory_order_relaxed);
+                    }
+                }
+
+                function_type* stored = stored_task(*cell);
+                function_type task{std::move(*stored)};
+                stored->~function_type();
+                cell->sequence.store(pos + mask + 1, std::memory_order_release);
+
+                if (task) {
+                    task(std::forward<Args>(args)...);
+                    return true;
+                }
+            }
+        }
+
+    private:
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        Cell* cells = nullptr;
+
+        const std::size_t mask;
+
+        alignas(cache_line_size) std::atomic<std::size_t> enqueue_position{0};
+
+        alignas(cache_line_size) std::atomic<std::size_t> dequeue_position{0};
+
+        //=================================================
+        // Helper functions
+        //=================================================
+
+        [[nodiscard]]
+        static constexpr std::size_t round_up_to_power_of_two(std::size_t n) {
+            std::size_t result = 2;
+            while (result < n) {
+                result *= 2;
+            }
+            return result;
+        }
+
+        [[nodiscard]]
+        static function_type* stored_task(Cell& cell) {
+            return std::launder(reinterpret_cast<function_type*>(cell.task));
+        }
+
+    };
+
+    //=====================================================
+    // Convenience type aliases
+    //=====================================================
+
+    template<class C>
+    using Task_queue = AA_SBO_task_queue<std::allocator<std::byte>, 48, C>;
+
+    template<std::size_t SB_size, class C>
+    using SBO_task_queue = AA_SBO_task_queue<std::allocator<std::byte>, SB_size, C>;
+
+}
+
+#endif //ATUL_TASK_QUEUE_HPP
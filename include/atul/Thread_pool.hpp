@@ -0,0 +1,948 @@
+#ifndef ATUL_THREAD_POOL_HPP
+#define ATUL_THREAD_POOL_HPP
+
+#include "Function.hpp"
+#include "Allocators.hpp"
+#include "Task_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace atul {
+
+    //=====================================================
+    // Work_stealing_deque
+    //=====================================================
+
+    ///
+    /// Chase-Lev work-stealing deque.
+    ///
+    /// The owning thread pushes and takes elements at the bottom while any
+    /// other thread may steal elements from the top. The ring buffer grows
+    /// as needed and superseded buffers are kept until the deque is
+    /// destroyed, since a concurrent thief may still be reading from them.
+    ///
+    /// A thief copies an element out before it knows whether its claim on it
+    /// will succeed. Elements are therefore held as arrays of atomic words
+    /// and moved in and out by relocation, which requires T to be trivially
+    /// relocatable. An element whose claim fails is discarded as raw bytes.
+    ///
+    /// @tparam T Trivially relocatable element type
+    template<class T>
+    class Work_stealing_deque {
+        static_assert(is_trivially_relocatable_v<T>);
+        static_assert(alignof(T) <= alignof(std::max_align_t));
+
+        using word_type = std::uintptr_t;
+
+        static constexpr std::size_t words_per_element = (sizeof(T) + sizeof(word_type) - 1) / sizeof(word_type);
+
+        struct Ring {
+            explicit Ring(std::int64_t capacity):
+                capacity(capacity),
+                words(new std::atomic<word_type>[static_cast<std::size_t>(capacity) * words_per_element]()) {}
+
+            const std::int64_t capacity;
+
+            std::unique_ptr<std::atomic<word_type>[]> words;
+
+            void put(std::int64_t i, const std::byte* source) noexcept {
+                alignas(word_type) word_type buffer[words_per_element] {};
+                std::memcpy(buffer, source, sizeof(T));
+
+                std::atomic<word_type>* slot = element(i);
+                for (std::size_t w = 0; w < words_per_element; ++w) {
+                    slot[w].store(buffer[w], std::memory_order_relaxed);
+                }
+            }
+
+            void get(std::int64_t i, std::byte* dest) const noexcept {
+                alignas(word_type) word_type buffer[words_per_element];
+
+                const std::atomic<word_type>* slot = element(i);
+                for (std::size_t w = 0; w < words_per_element; ++w) {
+                    buffer[w] = slot[w].load(std::memory_order_relaxed);
+                }
+
+                std::memcpy(dest, buffer, sizeof(T));
+            }
+
+            [[nodiscard]]
+            std::atomic<word_type>* element(std::int64_t i) const noexcept {
+                return words.get() + static_cast<std::size_t>(i & (capacity - 1)) * words_per_element;
+            }
+        };
+
+    public:
+
+        //=================================================
+        // Constants
+        //=================================================
+
+        static constexpr std::int64_t initial_capacity = 256;
+
+        static constexpr std::size_t cache_line_size = 64;
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        Work_stealing_deque():
+            ring(new Ring{initial_capacity}) {}
+
+        Work_stealing_deque(const Work_stealing_deque&) = delete;
+
+        Work_stealing_deque(Work_stealing_deque&&) = delete;
+
+        ~Work_stealing_deque() {
+            Ring* r = ring.load(std::memory_order_relaxed);
+            const std::int64_t b = bottom.load(std::memory_order_relaxed);
+            for (std::int64_t i = top.load(std::memory_order_relaxed); i < b; ++i) {
+                alignas(T) std::byte storage[sizeof(T)];
+                r->get(i, storage);
+                std::launder(reinterpret_cast<T*>(storage))->~T();
+            }
+
+            delete r;
+        }
+
+        //=================================================
+        // Assignment operators
+        //=================================================
+
+        Work_stealing_deque& operator=(const Work_stealing_deque&) = delete;
+
+        Work_stealing_deque& operator=(Work_stealing_deque&&) = delete;
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        ///
+        /// @return True if the deque appeared empty at some point during the
+        /// call
+        [[nodiscard]]
+        bool empty() const noexcept {
+            const std::int64_t t = top.load(std::memory_order_seq_cst);
+            const std::int64_t b = bottom.load(std::memory_order_seq_cst);
+            return b <= t;
+        }
+
+        //=================================================
+        // Owner operations
+        //=================================================
+
+        ///
+        /// Constructs an element at the bottom of the deque. May only be
+        /// called by the owning thread.
+        ///
+        template<class...Ctor_args>
+        void emplace(Ctor_args&&...ctor_args) {
+            const std::int64_t b = bottom.load(std::memory_order_relaxed);
+            const std::int64_t t = top.load(std::memory_order_acquire);
+            Ring* r = ring.load(std::memory_order_relaxed);
+
+            if (b - t > r->capacity - 1) {
+                r = grow(r, t, b);
+            }
+
+            alignas(T) std::byte storage[sizeof(T)];
+            new (storage) T(std::forward<Ctor_args>(ctor_args)...);
+
+            r->put(b, storage);
+            bottom.store(b + 1, std::memory_order_release);
+        }
+
+        ///
+        /// Relocates the most recently pushed element into dest. May only be
+        /// called by the owning thread.
+        ///
+        /// @param dest Uninitialized storage suitable for a T
+        /// @return True if an element was relocated into dest
+        bool take(std::byte* dest) noexcept {
+            const std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+            Ring* r = ring.load(std::memory_order_relaxed);
+            bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t t = top.load(std::memory_order_relaxed);
+
+            if (t > b) {
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+            if (t < b) {
+                r->get(b, dest);
+                return true;
+            }
+
+            // Last element, which a thief may be claiming concurrently
+            const bool claimed = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            if (claimed) {
+                r->get(b, dest);
+            }
+            return claimed;
+        }
+
+        //=================================================
+        // Thief operations
+        //=================================================
+
+        ///
+        /// Relocates the oldest element into dest. May be called from any
+        /// thread.
+        ///
+        /// @param dest Uninitialized storage suitable for a T
+        /// @return True if an element was relocated into dest. False if the
+        /// deque was empty or the element was claimed by another thread
+        bool steal(std::byte* dest) noexcept {
+            std::int64_t t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const std::int64_t b = bottom.load(std::memory_order_acquire);
+
+            if (t >= b) {
+                return false;
+            }
+
+            Ring* r = ring.load(std::memory_order_acquire);
+            r->get(t, dest);
+            return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        }
+
+    private:
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        alignas(cache_line_size) std::atomic<std::int64_t> top{0};
+
+        alignas(cache_line_size) std::atomic<std::int64_t> bottom{0};
+
+        std::atomic<Ring*> ring;
+
+        ///
+        /// Buffers replaced by larger ones. Only accessed by the owner
+        ///
+        std::vector<std::unique_ptr<Ring>> retired_rings{};
+
+        //=================================================
+        // Helper functions
+        //=================================================
+
+        Ring* grow(Ring* r, std::int64_t t, std::int64_t b) {
+            auto bigger = std::make_unique<Ring>(r->capacity * 2);
+            for (std::int64_t i = t; i < b; ++i) {
+                alignas(word_type) std::byte buffer[sizeof(T)];
+                r->get(i, buffer);
+                bigger->put(i, buffer);
+            }
+
+            retired_rings.emplace_back(r);
+            Ring* result = bigger.release();
+            ring.store(result, std::memory_order_release);
+            return result;
+        }
+
+    };
+
+    //=====================================================
+    // Future
+    //=====================================================
+
+    ///
+    /// Tag type selecting the Block_pool used for thread pool tasks and
+    /// future states
+    ///
+    struct Thread_pool_tag {};
+
+    ///
+    /// State shared between a Future and the task which fulfils it. Owned
+    /// jointly through an intrusive reference count.
+    ///
+    template<class T>
+    struct Future_state {
+        using allocator_type = Pool_allocator<Future_state, Thread_pool_tag>;
+
+        std::atomic<std::uint32_t> references{2};
+
+        std::atomic<bool> ready{false};
+
+        std::exception_ptr exception{};
+
+        alignas(T) std::byte value[sizeof(T)];
+
+        template<class...Ctor_args>
+        void set_value(Ctor_args&&...ctor_args) {
+            new (value) T(std::forward<Ctor_args>(ctor_args)...);
+            ready.store(true, std::memory_order_release);
+        }
+
+        [[nodiscard]]
+        T& get() noexcept {
+            return *std::launder(reinterpret_cast<T*>(value));
+        }
+
+        [[nodiscard]]
+        static Future_state* create() {
+            allocator_type allocator;
+            return new (allocator.allocate(1)) Future_state{};
+        }
+
+        void release() noexcept {
+            if (references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                return;
+            }
+
+            if (ready.load(std::memory_order_relaxed) && !exception) {
+                get().~T();
+            }
+
+            this->~Future_state();
+            allocator_type allocator;
+            allocator.deallocate(this, 1);
+        }
+    };
+
+    template<class T>
+    struct Future_state<T&> {
+        using allocator_type = Pool_allocator<Future_state, Thread_pool_tag>;
+
+        std::atomic<std::uint32_t> references{2};
+
+        std::atomic<bool> ready{false};
+
+        std::exception_ptr exception{};
+
+        T* pointer = nullptr;
+
+        void set_value(T& value) noexcept {
+            pointer = std::addressof(value);
+            ready.store(true, std::memory_order_release);
+        }
+
+        [[nodiscard]]
+        T& get() noexcept {
+            return *pointer;
+        }
+
+        [[nodiscard]]
+        static Future_state* create() {
+            allocator_type allocator;
+            return new (allocator.allocate(1)) Future_state{};
+        }
+
+        void release() noexcept {
+            if (references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                return;
+            }
+
+            this->~Future_state();
+            allocator_type allocator;
+            allocator.deallocate(this, 1);
+        }
+    };
+
+    template<>
+    struct Future_state<void> {
+        using allocator_type = Pool_allocator<Future_state, Thread_pool_tag>;
+
+        std::atomic<std::uint32_t> references{2};
+
+        std::atomic<bool> ready{false};
+
+        std::exception_ptr exception{};
+
+        void set_value() noexcept {
+            ready.store(true, std::memory_order_release);
+        }
+
+        [[nodiscard]]
+        static Future_state* create() {
+            allocator_type allocator;
+            return new (allocator.allocate(1)) Future_state{};
+        }
+
+        void release() noexcept {
+            if (references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                return;
+            }
+
+            this->~Future_state();
+            allocator_type allocator;
+            allocator.deallocate(this, 1);
+        }
+    };
+
+    ///
+    /// Handle to the eventual result of a task submitted to a thread pool.
+    ///
+    /// A Future is one pointer to a pooled shared state plus a reference to
+    /// its executor. Waiting on a Future runs other pending tasks from the
+    /// executor instead of blocking, so workers may wait on the results of
+    /// tasks they submit.
+    ///
+    /// The executor is only consulted while the result isn't ready. Since
+    /// destroying a pool runs every pending task, a Future may outlive the
+    /// pool which produced it and still be waited on.
+    ///
+    /// @tparam T Result type. May be an lvalue reference, in which case the
+    /// Future refers to the object the task returned a reference to
+    template<class T>
+    class Future {
+        static_assert(
+            !std::is_rvalue_reference_v<T>,
+            "Future does not support rvalue reference results. Return the object by value instead."
+        );
+
+    public:
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        Future() = default;
+
+        Future(Future_state<T>* state, Function_ref<bool()> help) noexcept:
+            state(state),
+            help(help) {}
+
+        Future(const Future&) = delete;
+
+        Future(Future&& other) noexcept:
+            state(std::exchange(other.state, nullptr)),
+            help(other.help) {}
+
+        ~Future() {
+            if (state) {
+                state->release();
+            }
+        }
+
+        //=================================================
+        // Assignment operators
+        //=================================================
+
+        Future& operator=(const Future&) = delete;
+
+        Future& operator=(Future&& rhs) noexcept {
+            if (this != &rhs) {
+                if (state) {
+                    state->release();
+                }
+
+                state = std::exchange(rhs.state, nullptr);
+                help = rhs.help;
+            }
+
+            return *this;
+        }
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        [[nodiscard]]
+        bool valid() const noexcept {
+            return state != nullptr;
+        }
+
+        [[nodiscard]]
+        bool is_ready() const noexcept {
+            return state->ready.load(std::memory_order_acquire);
+        }
+
+        //=================================================
+        // Misc.
+        //=================================================
+
+        ///
+        /// Runs pending tasks from the executor until the result is ready
+        ///
+        void wait() const {
+            // Once the result is ready, help may refer to a destroyed pool
+            while (!is_ready()) {
+                if (!help()) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        ///
+        /// Waits for the result and then retrieves it, leaving the Future
+        /// invalid
+        ///
+        /// @return Result of the task
+        T get() {
+            wait();
+
+            Future_state<T>* s = std::exchange(state, nullptr);
+            struct Release {
+                Future_state<T>* state;
+
+                ~Release() {
+                    state->release();
+                }
+            } release{s};
+
+            if (s->exception) {
+                std::rethrow_exception(s->exception);
+            }
+
+            if constexpr (std::is_lvalue_reference_v<T>) {
+                return s->get();
+            } else if constexpr (!std::is_void_v<T>) {
+                return std::move(s->get());
+            }
+        }
+
+    private:
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        Future_state<T>* state = nullptr;
+
+        Function_ref<bool()> help{&no_help};
+
+        //=================================================
+        // Helper functions
+        //=================================================
+
+        static bool no_help() {
+            return false;
+        }
+
+    };
+
+    ///
+    /// Task which invokes a callable and stores its result, or the exception
+    /// it threw, in a Future_state. Destroying a Packaged_task which never ran
+    /// breaks its promise.
+    ///
+    template<class Callable, class T>
+    class Packaged_task {
+    public:
+
+        Packaged_task(Future_state<T>* state, Callable&& callable):
+            state(state),
+            callable(std::move(callable)) {}
+
+        Packaged_task(Future_state<T>* state, const Callable& callable):
+            state(state),
+            callable(callable) {}
+
+        Packaged_task(Packaged_task&& other) noexcept:
+            state(std::exchange(other.state, nullptr)),
+            callable(std::move(other.callable)) {}
+
+        Packaged_task(const Packaged_task&) = delete;
+
+        ~Packaged_task() {
+            if (state) {
+                state->exception = std::make_exception_ptr(std::future_error{std::future_errc::broken_promise});
+                state->ready.store(true, std::memory_order_release);
+                state->release();
+            }
+        }
+
+        void operator()() {
+            Future_state<T>* s = std::exchange(state, nullptr);
+            try {
+                if constexpr (std::is_void_v<T>) {
+                    std::invoke(callable);
+                    s->set_value();
+                } else {
+                    s->set_value(std::invoke(callable));
+                }
+            } catch (...) {
+                s->exception = std::current_exception();
+                s->ready.store(true, std::memory_order_release);
+            }
+            s->release();
+        }
+
+    private:
+
+        Future_state<T>* state;
+
+        Callable callable;
+
+    };
+
+    template<class Callable, class T>
+    struct is_trivially_relocatable<Packaged_task<Callable, T>> : is_trivially_relocatable<Callable> {};
+
+    ///
+    /// Holds a task which can't be moved, so that AA_SBO_function keeps it
+    /// in allocated storage even if it would fit in the small buffer
+    ///
+    template<class Task>
+    class Pinned_task {
+    public:
+
+        explicit Pinned_task(Task&& task):
+            task(std::move(task)) {}
+
+        Pinned_task(const Pinned_task&) = delete;
+
+        Pinned_task(Pinned_task&&) = delete;
+
+        void operator()() {
+            task();
+        }
+
+    private:
+
+        Task task;
+
+    };
+
+    ///
+    /// Task type of SBO_thread_pool. The pool never places a callable which
+    /// isn't trivially relocatable in a task's small buffer, so unlike
+    /// AA_SBO_function in general, these tasks may be moved by copying their
+    /// bytes, as work-stealing deques do.
+    ///
+    template<class A, std::size_t SB_size>
+    class Relocatable_task : public AA_SBO_unique_function<A, SB_size, void()> {
+    public:
+
+        using AA_SBO_unique_function<A, SB_size, void()>::AA_SBO_unique_function;
+
+    };
+
+    template<class A, std::size_t SB_size>
+    struct is_trivially_relocatable<Relocatable_task<A, SB_size>> : std::true_type {};
+
+    //=====================================================
+    // SBO_thread_pool
+    //=====================================================
+
+    ///
+    /// A work-stealing thread pool.
+    ///
+    /// Tasks are move-only AA_SBO_function objects whose callables are
+    /// stored inline when they fit in SB_size bytes and are trivially
+    /// relocatable, and otherwise in blocks
+    /// from a Pool_allocator. Future states come from a Pool_allocator too,
+    /// so no task submission reaches the global allocator in the common
+    /// case.
+    ///
+    /// Each worker owns a Chase-Lev deque. Tasks submitted from a worker go
+    /// to the bottom of its own deque and are run in LIFO order by that
+    /// worker. Tasks submitted from other threads go to a shared bounded
+    /// queue. Idle workers steal the oldest tasks of randomly chosen victims
+    /// and sleep once no work can be found.
+    ///
+    /// Destroying the pool runs all pending tasks before joining the
+    /// workers.
+    ///
+    /// @tparam SB_size Size of each task's small buffer
+    template<std::size_t SB_size>
+    class SBO_thread_pool {
+    public:
+
+        //=================================================
+        // Type aliases
+        //=================================================
+
+        using allocator_type = Pool_allocator<std::byte, Thread_pool_tag>;
+
+        using task_type = Relocatable_task<allocator_type, SB_size>;
+
+        //=================================================
+        // Constants
+        //=================================================
+
+        static constexpr std::size_t injection_queue_capacity = 4096;
+
+        ///
+        /// Number of failed attempts at finding work before a worker sleeps
+        ///
+        static constexpr int spin_rounds = 64;
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        ///
+        /// @param thread_count Number of worker threads
+        explicit SBO_thread_pool(std::size_t thread_count = std::max(1u, std::thread::hardware_concurrency())):
+            workers(std::max(thread_count, std::size_t{1}))
+        {
+            threads.reserve(workers.size());
+            for (std::size_t i = 0; i < workers.size(); ++i) {
+                workers[i].random_state = static_cast<std::uint32_t>(i * 2654435761u + 1);
+                threads.emplace_back([this, i] () { run_worker(i); });
+            }
+        }
+
+        SBO_thread_pool(const SBO_thread_pool&) = delete;
+
+        SBO_thread_pool(SBO_thread_pool&&) = delete;
+
+        ~SBO_thread_pool() {
+            {
+                std::lock_guard<std::mutex> lock{sleep_mutex};
+                stopping = true;
+            }
+            sleep_condition.notify_all();
+
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+        }
+
+        //=================================================
+        // Assignment operators
+        //=================================================
+
+        SBO_thread_pool& operator=(const SBO_thread_pool&) = delete;
+
+        SBO_thread_pool& operator=(SBO_thread_pool&&) = delete;
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        [[nodiscard]]
+        std::size_t thread_count() const noexcept {
+            return workers.size();
+        }
+
+        //=================================================
+        // Misc.
+        //=================================================
+
+        ///
+        /// Schedules a callable for execution
+        ///
+        /// @param c Callable object taking no arguments
+        /// @return Future for the callable's result
+        template<class C>
+        auto submit(C&& c) -> Future<std::invoke_result_t<std::decay_t<C>&>> {
+            using Callable = std::decay_t<C>;
+            using result_type = std::invoke_result_t<Callable&>;
+
+            auto* state = Future_state<result_type>::create();
+            Future<result_type> future{state, Function_ref<bool()>{helper}};
+
+            post(Packaged_task<Callable, result_type>{state, std::forward<C>(c)});
+            return future;
+        }
+
+        ///
+        /// Runs one pending task on the calling thread, if any is available
+        ///
+        /// @return True if a task was run
+        bool run_pending_task() {
+            Worker* worker = (current_pool == this) ? &workers[current_worker] : nullptr;
+
+            if (worker) {
+                alignas(task_type) std::byte storage[sizeof(task_type)];
+                if (worker->deque.take(storage)) {
+                    run_relocated(storage);
+                    return true;
+                }
+            }
+
+            if (injection_queue.try_pop_invoke()) {
+                return true;
+            }
+
+            return try_steal(worker ? worker->random_state : external_random_state);
+        }
+
+    private:
+
+        struct alignas(Work_stealing_deque<task_type>::cache_line_size) Worker {
+            Work_stealing_deque<task_type> deque{};
+
+            std::uint32_t random_state = 1;
+        };
+
+        ///
+        /// Callable through which Futures run pending tasks while waiting
+        ///
+        struct Helper {
+            SBO_thread_pool* pool;
+
+            bool operator()() const {
+                return pool->run_pending_task();
+            }
+        };
+
+        //=================================================
+        // Static members
+        //=================================================
+
+        static inline thread_local SBO_thread_pool* current_pool = nullptr;
+
+        static inline thread_local std::size_t current_worker = 0;
+
+        static inline thread_local std::uint32_t external_random_state = 0x9e3779b9u;
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        std::vector<Worker> workers;
+
+        AA_SBO_task_queue<allocator_type, SB_size, void()> injection_queue{injection_queue_capacity};
+
+        Helper helper{this};
+
+        std::atomic<std::size_t> sleeping{0};
+
+        std::mutex sleep_mutex{};
+
+        std::condition_variable sleep_condition{};
+
+        bool stopping = false;
+
+        std::vector<std::thread> threads{};
+
+        //=================================================
+        // Helper functions
+        //=================================================
+
+        template<class Task>
+        void post(Task&& task) {
+            if (current_pool == this) {
+                using Callable = std::decay_t<Task>;
+                if constexpr (is_trivially_relocatable_v<Callable>) {
+                    workers[current_worker].deque.emplace(allocator_type{}, std::forward<Task>(task));
+                } else {
+                    workers[current_worker].deque.emplace(
+                        std::allocator_arg,
+                        allocator_type{},
+                        std::in_place_type<Pinned_task<Callable>>,
+                        std::forward<Task>(task)
+                    );
+                }
+            } else {
+                while (!injection_queue.try_push(std::forward<Task>(task))) {
+                    // Full queue. Make room by running a task here
+                    if (!run_pending_task()) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+
+            // Pairs with the fence in run_worker(). Either this thread sees a
+            // sleeping worker, or that worker sees the new task
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (sleeping.load(std::memory_order_relaxed) != 0) {
+                std::lock_guard<std::mutex> lock{sleep_mutex};
+                sleep_condition.notify_one();
+            }
+        }
+
+        static void run_relocated(std::byte* storage) {
+            task_type* task = std::launder(reinterpret_cast<task_type*>(storage));
+            struct Destroy {
+                task_type* task;
+
+                ~Destroy() {
+                    task->~task_type();
+                }
+            } destroy{task};
+
+            (*task)();
+        }
+
+        [[nodiscard]]
+        static std::uint32_t next_random(std::uint32_t& state) noexcept {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+
+        bool try_steal(std::uint32_t& random_state) {
+            const std::size_t n = workers.size();
+            const std::size_t first = next_random(random_state) % n;
+
+            alignas(task_type) std::byte storage[sizeof(task_type)];
+            for (std::size_t i = 0; i < n; ++i) {
+                Worker& victim = workers[(first + i) % n];
+                if (victim.deque.steal(storage)) {
+                    run_relocated(storage);
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        [[nodiscard]]
+        bool has_pending_tasks() const {
+            if (!injection_queue.empty()) {
+                return true;
+            }
+
+            return std::any_of(workers.begin(), workers.end(), [] (const Worker& w) {
+                return !w.deque.empty();
+            });
+        }
+
+        void run_worker(std::size_t index) {
+            current_pool = this;
+            current_worker = index;
+
+            while (true) {
+                bool found = false;
+                for (int i = 0; i < spin_rounds && !found; ++i) {
+                    found = run_pending_task();
+                    if (!found) {
+                        std::this_thread::yield();
+                    }
+                }
+
+                if (found) {
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock{sleep_mutex};
+                sleeping.fetch_add(1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                while (!stopping && !has_pending_tasks()) {
+                    sleep_condition.wait(lock);
+                }
+
+                sleeping.fetch_sub(1, std::memory_order_relaxed);
+                if (stopping && !has_pending_tasks()) {
+                    break;
+                }
+            }
+
+            current_pool = nullptr;
+        }
+
+    };
+
+    //=====================================================
+    // Convenience type aliases
+    //=====================================================
+
+    using Thread_pool = SBO_thread_pool<48>;
+
+}
+
+#endif //ATUL_THREAD_POOL_HPP
@@ -0,0 +1,591 @@
+#ifndef ATUL_TIMER_WHEEL_HPP
+#define ATUL_TIMER_WHEEL_HPP
+
+#include "Function.hpp"
+
+#include <aul/containers/Allocator_aware_base.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace atul {
+
+    //=====================================================
+    // Timer_id
+    //=====================================================
+
+    ///
+    /// Handle to a timer scheduled on a timer wheel. A handle whose timer has
+    /// fired or been cancelled is detected through its generation and never
+    /// refers to a timer scheduled later in the same position. A
+    /// default-constructed handle refers to no timer, since generations start
+    /// at 1.
+    ///
+    struct Timer_id {
+        std::uint32_t index = 0;
+
+        std::uint32_t generation = 0;
+    };
+
+    //=====================================================
+    // AA_SBO_timer_wheel
+    //=====================================================
+
+    ///
+    /// A hierarchical timer wheel which invokes callbacks once their deadline
+    /// has been reached.
+    ///
+    /// Time is measured in ticks of a caller-defined length. The wheel has
+    /// level_count levels of slots_per_level buckets each. A bucket at level L
+    /// spans 64^L ticks. A timer is placed at the level of the highest 6-bit
+    /// digit in which its deadline differs from the current time. When time
+    /// reaches the start of a bucket above level 0, the bucket's timers are
+    /// cascaded into lower levels. Level 0 buckets hold timers due on a single
+    /// tick and are fired as one batch.
+    ///
+    /// Scheduling and cancellation take constant time. Timers are entries in
+    /// fixed-size slabs obtained from the allocator and are linked into their
+    /// bucket by index, so neither operation allocates once the slabs have
+    /// grown to the peak number of timers. Each entry holds its callback in
+    /// an AA_SBO_unique_function, which stores callbacks that fit in its
+    /// small buffer without further allocation.
+    ///
+    /// advance() skips directly from one non-empty bucket to the next, using
+    /// a bitmap of occupied buckets per level, so its cost doesn't depend on
+    /// the number of ticks elapsed.
+    ///
+    /// The wheel is not thread-safe.
+    ///
+    /// @tparam A STL compatible allocator type
+    /// @tparam SB_size Size of each callback's small buffer
+    template<class A, std::size_t SB_size>
+    class AA_SBO_timer_wheel : public aul::Allocator_aware_base<typename std::allocator_traits<A>::template rebind_alloc<std::byte>> {
+        using a_base = aul::Allocator_aware_base<typename std::allocator_traits<A>::template rebind_alloc<std::byte>>;
+
+    public:
+
+        //=================================================
+        // Type aliases
+        //=================================================
+
+        using allocator_type = typename std::allocator_traits<A>::template rebind_alloc<std::byte>;
+
+        using function_type = AA_SBO_unique_function<allocator_type, SB_size, void()>;
+
+        using time_type = std::uint64_t;
+
+        using size_type = std::size_t;
+
+        //=================================================
+        // Constants
+        //=================================================
+
+        static constexpr std::size_t level_bits = 6;
+
+        static constexpr std::size_t slots_per_level = std::size_t{1} << level_bits;
+
+        static constexpr std::size_t level_count = (std::numeric_limits<time_type>::digits + level_bits - 1) / level_bits;
+
+        ///
+        /// Number of entries obtained from the allocator at a time
+        ///
+        static constexpr std::size_t slab_size = 256;
+
+    private:
+
+        static constexpr std::uint32_t null_index = std::numeric_limits<std::uint32_t>::max();
+
+        static constexpr std::size_t bucket_count = level_count * slots_per_level;
+
+        ///
+        /// Bucket of entries which are not currently scheduled
+        ///
+        static constexpr std::uint16_t no_bucket = bucket_count;
+
+        static constexpr time_type slot_mask = slots_per_level - 1;
+
+        struct Entry {
+            time_type deadline = 0;
+
+            std::uint32_t next = null_index;
+
+            std::uint32_t prev = null_index;
+
+            std::uint32_t generation = 1;
+
+            std::uint16_t bucket = no_bucket;
+
+            alignas(function_type) std::byte callback[sizeof(function_type)];
+        };
+
+        using entry_allocator_type = typename std::allocator_traits<A>::template rebind_alloc<Entry>;
+
+        using slab_list_allocator_type = typename std::allocator_traits<A>::template rebind_alloc<Entry*>;
+
+    public:
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        ///
+        /// @param now Current time. Timers due at or before it fire on the
+        /// next tick
+        /// @param a Allocator used for slabs and for callbacks which don't
+        /// fit in the small buffer
+        explicit AA_SBO_timer_wheel(time_type now = 0, const allocator_type& a = {}):
+            a_base(a),
+            slabs(slab_list_allocator_type{a}),
+            current(now)
+        {
+            std::fill(std::begin(heads), std::end(heads), null_index);
+            std::fill(std::begin(tails), std::end(tails), null_index);
+        }
+
+        AA_SBO_timer_wheel(const AA_SBO_timer_wheel&) = delete;
+
+        AA_SBO_timer_wheel(AA_SBO_timer_wheel&&) = delete;
+
+        ~AA_SBO_timer_wheel() {
+            clear();
+
+            entry_allocator_type allocator{a_base::get_allocator()};
+            for (Entry* slab : slabs) {
+                std::allocator_traits<entry_allocator_type>::deallocate(allocator, slab, slab_size);
+            }
+        }
+
+        //=================================================
+        // Assignment operators
+        //=================================================
+
+        AA_SBO_timer_wheel& operator=(const AA_SBO_timer_wheel&) = delete;
+
+        AA_SBO_timer_wheel& operator=(AA_SBO_timer_wheel&&) = delete;
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        ///
+        /// @return Time up to which all due timers have fired
+        [[nodiscard]]
+        time_type now() const noexcept {
+            return current;
+        }
+
+        ///
+        /// @return Number of scheduled timers
+        [[nodiscard]]
+        size_type size() const noexcept {
+            return timer_count;
+        }
+
+        [[nodiscard]]
+        bool empty() const noexcept {
+            return timer_count == 0;
+        }
+
+        ///
+        /// @param id Timer handle
+        /// @return True if the timer has neither fired nor been cancelled
+        [[nodiscard]]
+        bool pending(Timer_id id) const noexcept {
+            if (id.index >= entry_count) {
+                return false;
+            }
+
+            const Entry& entry = entry_at(id.index);
+            return entry.generation == id.generation && entry.bucket != no_bucket;
+        }
+
+        ///
+        /// The earliest time at which advance() has work to do. No timer is
+        /// due before then, so it's a suitable time to wake up at.
+        ///
+        /// @return Time of next cascade or batch of timers. The maximum
+        /// representable time if no timers are scheduled
+        [[nodiscard]]
+        time_type next_event() const noexcept {
+            time_type earliest = std::numeric_limits<time_type>::max();
+            for (std::size_t level = 0; level < level_count; ++level) {
+                const std::size_t shift = level * level_bits;
+                const std::size_t position = (current >> shift) & slot_mask;
+
+                // Buckets at or before the current position were emptied when
+                // time reached them
+                const std::uint64_t later_slots = position == slot_mask ? 0 : ~std::uint64_t{0} << (position + 1);
+                const std::uint64_t occupied = occupancy[level] & later_slots;
+                if (!occupied) {
+                    continue;
+                }
+
+                const std::size_t upper_shift = shift + level_bits;
+                const time_type upper = upper_shift >= std::numeric_limits<time_type>::digits ? 0 : (current >> upper_shift) << upper_shift;
+                const time_type candidate = upper | (time_type{lowest_set_bit(occupied)} << shift);
+
+                earliest = std::min(earliest, candidate);
+            }
+
+            return earliest;
+        }
+
+        //=================================================
+        // Modifiers
+        //=================================================
+
+        ///
+        /// Schedules c to be invoked once time reaches deadline. A deadline
+        /// which has already passed is treated as the next tick.
+        ///
+        /// @param deadline Time at which to invoke c
+        /// @param c Callable object or function_type
+        /// @return Handle which may be used to cancel the timer
+        template<class C>
+        Timer_id schedule(time_type deadline, C&& c) {
+            const std::uint32_t index = acquire_entry();
+            Entry& entry = entry_at(index);
+
+            try {
+                new (entry.callback) function_type(std::allocator_arg, a_base::get_allocator(), std::forward<C>(c));
+            } catch (...) {
+                release_entry(index);
+                throw;
+            }
+
+            entry.deadline = std::max(deadline, current + 1);
+            insert(index);
+            ++timer_count;
+
+            return Timer_id{index, entry.generation};
+        }
+
+        ///
+        /// Cancels the timer referred to by id without invoking it. Has no
+        /// effect if the timer already fired or was cancelled.
+        ///
+        /// @param id Handle returned by schedule()
+        /// @return True if a timer was cancelled
+        bool cancel(Timer_id id) noexcept {
+            if (!pending(id)) {
+                return false;
+            }
+
+            unlink(id.index);
+            stored_callback(entry_at(id.index))->~function_type();
+            release_entry(id.index);
+            --timer_count;
+
+            return true;
+        }
+
+        ///
+        /// Cancels all timers
+        ///
+        void clear() noexcept {
+            for (std::size_t bucket = 0; bucket < bucket_count; ++bucket) {
+                while (heads[bucket] != null_index) {
+                    const std::uint32_t index = heads[bucket];
+                    unlink(index);
+                    stored_callback(entry_at(index))->~function_type();
+                    release_entry(index);
+                }
+            }
+
+            timer_count = 0;
+        }
+
+        //=================================================
+        // Misc.
+        //=================================================
+
+        ///
+        /// Advances time to now, invoking every timer whose deadline is at
+        /// or before it. Timers are invoked in order of deadline, and in
+        /// order of scheduling among timers with the same deadline. During a
+        /// callback, now() returns the callback's deadline.
+        ///
+        /// Callbacks may schedule and cancel timers. Timers they schedule
+        /// fire no earlier than the next tick.
+        ///
+        /// If a callback throws, the remaining timers due on the same tick
+        /// are still invoked before the first exception is rethrown. Timers
+        /// due on later ticks are left scheduled.
+        ///
+        /// @param now New current time. Has no effect if not later than the
+        /// current time
+        /// @return Number of timers invoked
+        size_type advance(time_type now) {
+            size_type fired = 0;
+            while (timer_count != 0) {
+                const time_type next = next_event();
+                if (next > now) {
+                    break;
+                }
+
+                current = next;
+                cascade();
+                fired += fire_bucket(static_cast<std::size_t>(current & slot_mask));
+            }
+
+            current = std::max(current, now);
+            return fired;
+        }
+
+    private:
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        std::vector<Entry*, slab_list_allocator_type> slabs;
+
+        ///
+        /// Number of entries which have ever been used
+        ///
+        std::uint32_t entry_count = 0;
+
+        ///
+        /// Head of the list of released entries, linked through Entry::next
+        ///
+        std::uint32_t free_head = null_index;
+
+        size_type timer_count = 0;
+
+        time_type current = 0;
+
+        std::uint32_t heads[bucket_count];
+
+        std::uint32_t tails[bucket_count];
+
+        ///
+        /// One bit per bucket of each level, set if the bucket is non-empty
+        ///
+        std::uint64_t occupancy[level_count]{};
+
+        //=================================================
+        // Helper functions
+        //=================================================
+
+        [[nodiscard]]
+        static std::size_t lowest_set_bit(std::uint64_t x) noexcept {
+            std::size_t bit = 0;
+            for (std::size_t width = 32; width != 0; width /= 2) {
+                const std::uint64_t low_mask = (std::uint64_t{1} << width) - 1;
+                if ((x & low_mask) == 0) {
+                    x >>= width;
+                    bit += width;
+                }
+            }
+
+            return bit;
+        }
+
+        [[nodiscard]]
+        Entry& entry_at(std::uint32_t index) noexcept {
+            return slabs[index / slab_size][index % slab_size];
+        }
+
+        [[nodiscard]]
+        const Entry& entry_at(std::uint32_t index) const noexcept {
+            return slabs[index / slab_size][index % slab_size];
+        }
+
+        [[nodiscard]]
+        static function_type* stored_callback(Entry& entry) noexcept {
+            return std::launder(reinterpret_cast<function_type*>(entry.callback));
+        }
+
+        [[nodiscard]]
+        std::uint32_t acquire_entry() {
+            if (free_head != null_index) {
+                const std::uint32_t index = free_head;
+                free_head = entry_at(index).next;
+                return index;
+            }
+
+            if (entry_count == null_index) {
+                throw std::length_error{"atul::AA_SBO_timer_wheel: too many timers"};
+            }
+
+            if (entry_count == slabs.size() * slab_size) {
+                allocate_slab();
+            }
+
+            return entry_count++;
+        }
+
+        void release_entry(std::uint32_t index) noexcept {
+            Entry& entry = entry_at(index);
+            if (++entry.generation == 0) {
+                entry.generation = 1;
+            }
+            entry.bucket = no_bucket;
+            entry.prev = null_index;
+            entry.next = free_head;
+            free_head = index;
+        }
+
+        void allocate_slab() {
+            entry_allocator_type allocator{a_base::get_allocator()};
+            Entry* slab = std::allocator_traits<entry_allocator_type>::allocate(allocator, slab_size);
+
+            try {
+                slabs.push_back(slab);
+            } catch (...) {
+                std::allocator_traits<entry_allocator_type>::deallocate(allocator, slab, slab_size);
+                throw;
+            }
+
+            for (std::size_t i = 0; i < slab_size; ++i) {
+                new (slab + i) Entry{};
+            }
+        }
+
+        ///
+        /// Places a scheduled entry in the bucket for its deadline, relative
+        /// to the current time. An entry due exactly now goes in the level 0
+        /// bucket of the current tick.
+        ///
+        void insert(std::uint32_t index) noexcept {
+            const time_type deadline = entry_at(index).deadline;
+
+            std::size_t level = 0;
+            for (time_type difference = (deadline ^ current) >> level_bits; difference != 0; difference >>= level_bits) {
+                ++level;
+            }
+
+            const std::size_t slot = static_cast<std::size_t>((deadline >> (level * level_bits)) & slot_mask);
+            link(index, level * slots_per_level + slot);
+        }
+
+        void link(std::uint32_t index, std::size_t bucket) noexcept {
+            Entry& entry = entry_at(index);
+            entry.bucket = static_cast<std::uint16_t>(bucket);
+            entry.next = null_index;
+            entry.prev = tails[bucket];
+
+            if (tails[bucket] == null_index) {
+                heads[bucket] = index;
+                occupancy[bucket / slots_per_level] |= std::uint64_t{1} << (bucket % slots_per_level);
+            } else {
+                entry_at(tails[bucket]).next = index;
+            }
+
+            tails[bucket] = index;
+        }
+
+        void unlink(std::uint32_t index) noexcept {
+            Entry& entry = entry_at(index);
+            const std::size_t bucket = entry.bucket;
+
+            if (entry.prev == null_index) {
+                heads[bucket] = entry.next;
+            } else {
+                entry_at(entry.prev).next = entry.next;
+            }
+
+            if (entry.next == null_index) {
+                tails[bucket] = entry.prev;
+            } else {
+                entry_at(entry.next).prev = entry.prev;
+            }
+
+            if (heads[bucket] == null_index) {
+                occupancy[bucket / slots_per_level] &= ~(std::uint64_t{1} << (bucket % slots_per_level));
+            }
+
+            entry.next = null_index;
+            entry.prev = null_index;
+        }
+
+        ///
+        /// Redistributes the timers of every bucket above level 0 which
+        /// starts at the current time. Higher levels go first so that timers
+        /// may cascade through several levels at once.
+        ///
+        void cascade() noexcept {
+            for (std::size_t level = level_count - 1; level != 0; --level) {
+                const std::size_t shift = level * level_bits;
+                if ((current & ((time_type{1} << shift) - 1)) != 0) {
+                    continue;
+                }
+
+                const std::size_t bucket = level * slots_per_level + static_cast<std::size_t>((current >> shift) & slot_mask);
+                std::uint32_t index = heads[bucket];
+                heads[bucket] = null_index;
+                tails[bucket] = null_index;
+                occupancy[level] &= ~(std::uint64_t{1} << (bucket % slots_per_level));
+
+                while (index != null_index) {
+                    const std::uint32_t next = entry_at(index).next;
+                    insert(index);
+                    index = next;
+                }
+            }
+        }
+
+        ///
+        /// Invokes and releases every timer in a level 0 bucket. Each entry is
+        /// released before its callback runs, so callbacks may freely
+        /// schedule and cancel timers, including the one being invoked.
+        ///
+        /// The bucket is always drained, since next_event() never looks at
+        /// the current tick's bucket again. The first exception thrown by a
+        /// callback is rethrown afterwards.
+        ///
+        size_type fire_bucket(std::size_t bucket) {
+            size_type fired = 0;
+            std::exception_ptr exception{};
+            while (heads[bucket] != null_index) {
+                const std::uint32_t index = heads[bucket];
+                unlink(index);
+
+                function_type* stored = stored_callback(entry_at(index));
+                function_type callback{std::move(*stored)};
+                stored->~function_type();
+                release_entry(index);
+                --timer_count;
+
+                if (callback) {
+                    try {
+                        callback();
+                    } catch (...) {
+                        if (!exception) {
+                            exception = std::current_exception();
+                        }
+                    }
+                }
+                ++fired;
+            }
+
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+
+            return fired;
+        }
+
+    };
+
+    //=====================================================
+    // Convenience type aliases
+    //=====================================================
+
+    using Timer_wheel = AA_SBO_timer_wheel<std::allocator<std::byte>, 48>;
+
+    template<std::size_t SB_size>
+    using SBO_timer_wheel = AA_SBO_timer_wheel<std::allocator<std::byte>, SB_size>;
+
+}
+
+#endif //ATUL_TIMER_WHEEL_HPP
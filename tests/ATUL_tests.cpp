@@ -1,6 +1,15 @@
 #include <gtest/gtest.h>
 
 #include "Function_tests.hpp"
+#include "Allocators_tests.hpp"
+#include "Function_vector_tests.hpp"
+#include "Inplace_function_tests.hpp"
+#include "Signal_tests.hpp"
+#include "Task_queue_tests.hpp"
+#include "Thread_pool_tests.hpp"
+#include "Timer_wheel_tests.hpp"
+#include "Coroutine_tests.hpp"
+#include "Composition_tests.hpp"
 
 int main(int argc, char* argv[]) {
     ::testing::InitGoogleTest(&argc, argv);
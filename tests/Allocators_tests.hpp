@@ -0,0 +1,422 @@
+#ifndef ATUL_ALLOCATORS_TESTS
+#define ATUL_ALLOCATORS_TESTS
+
+#include <atul/Allocators.hpp>
+#include <atul/Function.hpp>
+
+#include <memory_resource>
+#include <array>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+namespace atul::tests {
+
+    ///
+    /// Memory resource which counts calls made to it
+    ///
+    class Counting_resource : public std::pmr::memory_resource {
+    public:
+
+        std::size_t allocations = 0;
+
+        std::size_t deallocations = 0;
+
+    private:
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            ++allocations;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+            ++deallocations;
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+    };
+
+    ///
+    /// Allocator which claims deallocation is a no-op but counts calls to
+    /// deallocate regardless
+    ///
+    template<class T>
+    struct Noop_deallocation_allocator {
+        using value_type = T;
+
+        using is_deallocation_noop = std::true_type;
+
+        static inline std::size_t deallocations = 0;
+
+        Noop_deallocation_allocator() = default;
+
+        template<class U>
+        Noop_deallocation_allocator(const Noop_deallocation_allocator<U>&) {}
+
+        T* allocate(std::size_t n) {
+            return static_cast<T*>(buffer.allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T*, std::size_t) {
+            ++deallocations;
+        }
+
+        template<class U>
+        bool operator==(const Noop_deallocation_allocator<U>&) const {
+            return true;
+        }
+
+        template<class U>
+        bool operator!=(const Noop_deallocation_allocator<U>&) const {
+            return false;
+        }
+
+        static inline std::pmr::monotonic_buffer_resource buffer{};
+    };
+
+    //=====================================================
+    // Allocator trait tests
+    //=====================================================
+
+    static_assert(is_deallocation_noop_v<Arena_allocator<int>>);
+    static_assert(!is_deallocation_noop_v<std::allocator<int>>);
+    static_assert(!is_deallocation_noop_v<std::pmr::polymorphic_allocator<int>>);
+
+    //=====================================================
+    // Arena_allocator tests
+    //=====================================================
+
+    TEST(Arena_allocator_tests, Functions_never_deallocate) {
+        Counting_resource upstream;
+
+        {
+            std::pmr::monotonic_buffer_resource arena{&upstream};
+            Arena_allocator<std::byte> allocator{arena};
+
+            std::array<int, 32> values{};
+            int sum = 0;
+            for (int i = 0; i < 1000; ++i) {
+                values[0] = i;
+                Arena_function<int()> function{allocator, [values] () { return values[0]; }};
+                sum += function();
+            }
+
+            EXPECT_EQ(sum, 999 * 1000 / 2);
+            EXPECT_GT(upstream.allocations, 0u);
+            EXPECT_EQ(upstream.deallocations, 0u);
+        }
+
+        EXPECT_EQ(upstream.deallocations, upstream.allocations);
+    }
+
+    TEST(Arena_allocator_tests, Copies_share_arena) {
+        std::pmr::monotonic_buffer_resource arena;
+        Arena_allocator<std::byte> allocator{arena};
+
+        std::array<int, 32> values{};
+        values[0] = 7;
+
+        Arena_SBO_function<16, int()> function{allocator, [values] () { return values[0]; }};
+        Arena_SBO_function<16, int()> function_copy{function};
+
+        EXPECT_EQ(function_copy(), 7);
+        EXPECT_EQ(function_copy.get_allocator(), allocator);
+    }
+
+    TEST(Arena_allocator_tests, Deallocate_is_skipped) {
+        Noop_deallocation_allocator<std::byte>::deallocations = 0;
+
+        std::array<int, 32> values{};
+        {
+            AA_function<Noop_deallocation_allocator<std::byte>, int()> function{[values] () { return values[0]; }};
+            EXPECT_EQ(function(), 0);
+        }
+
+        EXPECT_EQ(Noop_deallocation_allocator<std::byte>::deallocations, 0u);
+    }
+
+    //=====================================================
+    // Pool_allocator tests
+    //=====================================================
+
+    static_assert(std::allocator_traits<Pool_allocator<int, void>>::is_always_equal::value);
+    static_assert(is_trivially_relocatable_v<AA_function<Pool_allocator<std::byte>, void()>>);
+
+    TEST(Pool_allocator_tests, Blocks_are_reused) {
+        struct Tag {};
+        Pool_allocator<std::byte, Tag> allocator;
+
+        std::byte* a = allocator.allocate(40);
+        allocator.deallocate(a, 40);
+
+        std::byte* b = allocator.allocate(48);
+        EXPECT_EQ(a, b);
+        allocator.deallocate(b, 48);
+    }
+
+    TEST(Pool_allocator_tests, Distinct_blocks) {
+        struct Tag {};
+        Pool_allocator<std::byte, Tag> allocator;
+
+        std::vector<std::byte*> blocks;
+        for (int i = 0; i < 1000; ++i) {
+            std::byte* p = allocator.allocate(24);
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % 16, 0u);
+            std::fill(p, p + 24, std::byte{0xAB});
+            blocks.push_back(p);
+        }
+
+        std::sort(blocks.begin(), blocks.end());
+        EXPECT_EQ(std::adjacent_find(blocks.begin(), blocks.end()), blocks.end());
+
+        for (std::byte* p : blocks) {
+            allocator.deallocate(p, 24);
+        }
+    }
+
+    TEST(Pool_allocator_tests, Large_and_over_aligned_requests) {
+        Pool_allocator<std::byte> allocator;
+
+        std::byte* large = allocator.allocate(4096);
+        allocator.deallocate(large, 4096);
+
+        struct alignas(64) Over_aligned { std::byte data[64]; };
+        Pool_allocator<Over_aligned> aligned_allocator;
+        Over_aligned* p = aligned_allocator.allocate(1);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % 64, 0u);
+        aligned_allocator.deallocate(p, 1);
+    }
+
+    TEST(Pool_allocator_tests, Cross_thread_deallocation) {
+        struct Tag {};
+        using function_type = AA_function<Pool_allocator<std::byte, Tag>, int()>;
+
+        constexpr int n = 2000;
+        std::vector<function_type> functions;
+        functions.reserve(n);
+
+        std::array<int, 8> values{};
+        for (int i = 0; i < n; ++i) {
+            values[0] = i;
+            functions.emplace_back([values] () { return values[0]; });
+        }
+
+        std::thread consumer{[&] () {
+            long long sum = 0;
+            for (auto& f : functions) {
+                sum += f();
+            }
+            EXPECT_EQ(sum, static_cast<long long>(n) * (n - 1) / 2);
+            functions.clear();
+        }};
+        consumer.join();
+
+        EXPECT_TRUE(functions.empty());
+    }
+
+    TEST(Pool_allocator_tests, Deallocation_after_thread_cache_teardown) {
+        struct Tag {};
+        using pool = Block_pool<Tag>;
+
+        // Constructed before the thread's cache, so destroyed after it
+        struct Late_release {
+            void* block = nullptr;
+
+            ~Late_release() {
+                pool::deallocate(block, 32, 16);
+            }
+        };
+
+        void* late_block = nullptr;
+        std::thread{[&late_block] () {
+            thread_local Late_release late_release;
+            late_release.block = pool::allocate(32, 16);
+            late_block = late_release.block;
+        }}.join();
+
+        // The block must have reached the shared pool, from which a fresh
+        // thread's first batch is taken
+        std::vector<void*> blocks;
+        std::thread{[&blocks] () {
+            for (std::size_t i = 0; i < pool::batch_size; ++i) {
+                blocks.push_back(pool::allocate(32, 16));
+            }
+            for (void* block : blocks) {
+                pool::deallocate(block, 32, 16);
+            }
+        }}.join();
+
+        EXPECT_NE(std::find(blocks.begin(), blocks.end(), late_block), blocks.end());
+    }
+
+
+    //=====================================================
+    // pmr::Function tests
+    //=====================================================
+
+    static_assert(std::uses_allocator_v<pmr::Function<int()>, std::pmr::polymorphic_allocator<pmr::Function<int()>>>);
+
+    TEST(Pmr_function_tests, Vector_elements_use_vector_resource) {
+        Counting_resource resource;
+        std::array<int, 32> values{};
+        values[0] = 3;
+
+        {
+            std::pmr::vector<pmr::Function<int()>> functions{&resource};
+            functions.reserve(4);
+            const std::size_t vector_allocations = resource.allocations;
+
+            functions.emplace_back([values] () { return values[0]; });
+            functions.emplace_back([] () { return 4; });
+            functions.emplace_back();
+            EXPECT_EQ(resource.allocations, vector_allocations + 1);
+
+            for (const auto& function : functions) {
+                EXPECT_EQ(function.get_allocator().resource(), &resource);
+            }
+
+            EXPECT_EQ(functions[0](), 3);
+            EXPECT_EQ(functions[1](), 4);
+            EXPECT_FALSE(functions[2]);
+
+            // Growing the vector moves elements without reallocating callables
+            functions.reserve(64);
+            EXPECT_EQ(resource.allocations, vector_allocations + 2);
+            EXPECT_EQ(functions[0](), 3);
+        }
+
+        EXPECT_EQ(resource.deallocations, resource.allocations);
+    }
+
+    TEST(Pmr_function_tests, Copy_into_container_adopts_its_resource) {
+        Counting_resource a;
+        Counting_resource b;
+        std::array<int, 32> values{};
+        values[0] = 5;
+
+        pmr::SBO_function<16, int()> function{&a, [values] () { return values[0]; }};
+        EXPECT_EQ(a.allocations, 1u);
+
+        {
+            std::pmr::vector<pmr::SBO_function<16, int()>> functions{&b};
+            functions.push_back(function);
+            functions.push_back(std::move(function));
+
+            EXPECT_EQ(functions[0].get_allocator().resource(), &b);
+            EXPECT_EQ(functions[1].get_allocator().resource(), &b);
+            EXPECT_EQ(functions[0](), 5);
+            EXPECT_EQ(functions[1](), 5);
+            EXPECT_FALSE(function);
+        }
+
+        EXPECT_EQ(a.deallocations, a.allocations);
+        EXPECT_EQ(b.deallocations, b.allocations);
+    }
+
+    TEST(Pmr_function_tests, Assignment_keeps_resource) {
+        Counting_resource a;
+        Counting_resource b;
+        std::array<int, 32> values{};
+        values[0] = 6;
+
+        pmr::Function<int()> source{&a, [values] () { return values[0]; }};
+        pmr::Function<int()> destination{std::allocator_arg, &b};
+
+        destination = source;
+        EXPECT_EQ(destination.get_allocator().resource(), &b);
+        EXPECT_EQ(destination(), 6);
+
+        destination = std::move(source);
+        EXPECT_EQ(destination.get_allocator().resource(), &b);
+        EXPECT_EQ(destination(), 6);
+    }
+
+
+    //=====================================================
+    // Allocator-aware move and swap tests
+    //=====================================================
+
+    static_assert(std::is_nothrow_move_assignable_v<Function<int()>>);
+    static_assert(std::is_nothrow_swappable_v<Function<int()>>);
+    static_assert(!std::is_nothrow_move_assignable_v<pmr::Function<int()>>);
+
+    TEST(Allocator_aware_move_tests, Equal_allocators_transfer_allocation) {
+        Counting_resource resource;
+        std::array<int, 32> values{};
+        values[0] = 2;
+
+        pmr::Function<int()> source{&resource, [values] () { return values[0]; }};
+        pmr::Function<int()> destination{std::allocator_arg, &resource};
+        EXPECT_EQ(resource.allocations, 1u);
+
+        destination = std::move(source);
+        EXPECT_EQ(resource.allocations, 1u);
+        EXPECT_EQ(resource.deallocations, 0u);
+        EXPECT_FALSE(source);
+        EXPECT_EQ(destination(), 2);
+    }
+
+    TEST(Allocator_aware_move_tests, Unequal_allocators_move_callable) {
+        Counting_resource a;
+        Counting_resource b;
+        std::array<int, 32> values{};
+        values[0] = 3;
+
+        {
+            pmr::Function<int()> source{&a, [values] () { return values[0]; }};
+            pmr::Function<int()> destination{std::allocator_arg, &b};
+
+            destination = std::move(source);
+            EXPECT_EQ(a.deallocations, 1u);
+            EXPECT_EQ(b.allocations, 1u);
+            EXPECT_FALSE(source);
+            EXPECT_EQ(destination(), 3);
+        }
+
+        EXPECT_EQ(b.deallocations, 1u);
+    }
+
+    TEST(Allocator_aware_move_tests, Swap_with_equal_allocators) {
+        Counting_resource resource;
+        std::array<int, 32> values{};
+        values[0] = 4;
+
+        pmr::SBO_function<16, int()> heap{&resource, [values] () { return values[0]; }};
+        pmr::SBO_function<16, int()> inline_function{&resource, [] () { return 5; }};
+
+        swap(heap, inline_function);
+        EXPECT_EQ(heap(), 5);
+        EXPECT_EQ(inline_function(), 4);
+        EXPECT_EQ(resource.allocations, 1u);
+        EXPECT_EQ(resource.deallocations, 0u);
+    }
+
+    TEST(Allocator_aware_move_tests, Swap_with_unequal_allocators) {
+        Counting_resource a;
+        Counting_resource b;
+        std::array<int, 32> values{};
+
+        {
+            values[0] = 6;
+            pmr::Function<int()> first{&a, [values] () { return values[0]; }};
+            values[0] = 7;
+            pmr::Function<int()> second{&b, [values] () { return values[0]; }};
+
+            first.swap(second);
+            EXPECT_EQ(first(), 7);
+            EXPECT_EQ(second(), 6);
+            EXPECT_EQ(first.get_allocator().resource(), &a);
+            EXPECT_EQ(second.get_allocator().resource(), &b);
+        }
+
+        EXPECT_EQ(a.deallocations, a.allocations);
+        EXPECT_EQ(b.deallocations, b.allocations);
+    }
+
+}
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef ATUL_COMPOSITION_TESTS
+#define ATUL_COMPOSITION_TESTS
+
+#include <atul/Composition.hpp>
+#include <atul/Function.hpp>
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace atul::tests {
+
+    //=====================================================
+    // Helper functions
+    //=====================================================
+
+    int composition_add_one(int x) {
+        return x + 1;
+    }
+
+    int composition_subtract(int x, int y) {
+        return x - y;
+    }
+
+    //=====================================================
+    // compose tests
+    //=====================================================
+
+    TEST(Composition_tests, Applies_right_to_left) {
+        auto twice = [] (int x) { return x * 2; };
+        auto to_string = [] (int x) { return std::to_string(x); };
+
+        auto composed = atul::compose(to_string, twice, composition_add_one);
+        EXPECT_EQ(composed(4), "10");
+
+        auto sum = atul::compose(twice, [] (int x, int y) { return x + y; });
+        EXPECT_EQ(sum(2, 3), 10);
+    }
+
+    TEST(Composition_tests, Nested_compositions_are_flattened) {
+        auto twice = [] (int x) { return x * 2; };
+        auto inner = atul::compose(twice, twice);
+        auto outer = atul::compose(inner, atul::compose(twice, composition_add_one));
+
+        static_assert(std::is_same_v<
+            decltype(outer),
+            Composition<decltype(twice), decltype(twice), decltype(twice), int (*)(int)>
+        >);
+        EXPECT_EQ(outer(1), 16);
+    }
+
+    TEST(Composition_tests, Stateless_operands_take_no_space) {
+        auto twice = [] (int x) { return x * 2; };
+        auto negate = [] (int x) { return -x; };
+        auto composed = atul::compose(twice, negate, twice);
+
+        static_assert(std::is_empty_v<decltype(composed)>);
+        static_assert(is_stateless_callable_v<decltype(composed)>);
+        static_assert(SBO_function<0, int(int)>::stores_inline<decltype(composed)>);
+
+        SBO_function<0, int(int)> function{composed};
+        EXPECT_EQ(function(3), -12);
+    }
+
+    TEST(Composition_tests, Stateful_operands_share_one_buffer) {
+        int offset = 5;
+        auto add_offset = [&offset] (int x) { return x + offset; };
+        auto scale = [factor = 3] (int x) { return x * factor; };
+        auto composed = atul::compose(add_offset, scale, composition_add_one);
+
+        static_assert(sizeof(composed) <= 3 * sizeof(void*));
+        static_assert(SBO_function<32, int(int)>::stores_inline<decltype(composed)>);
+
+        SBO_function<32, int(int)> function{std::move(composed)};
+        EXPECT_EQ(function(1), 11);
+        offset = 0;
+        EXPECT_EQ(function(1), 6);
+    }
+
+    TEST(Composition_tests, Mutable_operands) {
+        auto counter = [count = 0] (int x) mutable { return x + ++count; };
+        auto composed = atul::compose(counter, composition_add_one);
+
+        EXPECT_EQ(composed(0), 2);
+        EXPECT_EQ(composed(0), 3);
+
+        static_assert(!std::is_invocable_v<const decltype(composed)&, int>);
+        static_assert(std::is_invocable_v<decltype(composed)&, int>);
+    }
+
+    TEST(Composition_tests, Move_only_operands) {
+        auto owner = [p = std::make_unique<int>(7)] (int x) { return x + *p; };
+        auto composed = atul::compose(std::move(owner), composition_add_one);
+
+        Unique_function<int(int)> function{std::move(composed)};
+        EXPECT_EQ(function(1), 9);
+    }
+
+    //=====================================================
+    // bind_front tests
+    //=====================================================
+
+    TEST(Composition_tests, Bind_front) {
+        auto bound = atul::bind_front(composition_subtract, 10);
+        EXPECT_EQ(bound(3), 7);
+
+        auto concatenate = [] (const std::string& a, const std::string& b, const std::string& c) {
+            return a + b + c;
+        };
+
+        auto hello = atul::bind_front(concatenate, std::string{"Hello"});
+        EXPECT_EQ(hello(", ", "world"), "Hello, world");
+    }
+
+    TEST(Composition_tests, Nested_binders_are_flattened) {
+        auto sum3 = [] (int a, int b, int c) { return a * 100 + b * 10 + c; };
+        auto bound = atul::bind_front(bind_front(sum3, 1), 2);
+
+        static_assert(std::is_same_v<decltype(bound), Front_binder<decltype(sum3), int, int>>);
+        static_assert(sizeof(bound) == 2 * sizeof(int));
+        EXPECT_EQ(bound(3), 123);
+    }
+
+    TEST(Composition_tests, Bound_arguments_are_lvalues) {
+        auto append = [] (std::string& s, char c) { s += c; return s.size(); };
+        auto bound = atul::bind_front(append, std::string{});
+
+        EXPECT_EQ(bound('a'), 1u);
+        EXPECT_EQ(bound('b'), 2u);
+        static_assert(!std::is_invocable_v<const decltype(bound)&, char>);
+    }
+
+    TEST(Composition_tests, Member_functions) {
+        struct Accumulator {
+            int total = 0;
+
+            int add(int x) {
+                return total += x;
+            }
+        };
+
+        Accumulator accumulator;
+        auto add = atul::bind_front(&Accumulator::add, &accumulator);
+        auto add_twice = atul::compose(add, add);
+
+        SBO_function<sizeof(add_twice), int(int)> function{add_twice};
+        EXPECT_EQ(function(1), 2);
+        EXPECT_EQ(accumulator.total, 2);
+    }
+
+    TEST(Composition_tests, Pipeline_fits_one_buffer) {
+        auto parse = [] (int x) { return x * 10; };
+        auto validate = [] (int x) { return x < 0 ? 0 : x; };
+        auto log = [] (int x) { return x; };
+        auto handler = atul::bind_front([] (int base, int x) { return base + x; }, 1000);
+
+        auto pipeline = atul::compose(log, validate, handler, parse, log, validate, composition_add_one);
+        static_assert(sizeof(pipeline) <= 3 * sizeof(void*));
+        static_assert(SBO_function<3 * sizeof(void*), int(int)>::stores_inline<decltype(pipeline)>);
+
+        SBO_function<3 * sizeof(void*), int(int)> function{pipeline};
+        EXPECT_EQ(function(4), 1050);
+    }
+
+}
+
+#endif
@@ -0,0 +1,188 @@
+#ifndef ATUL_COROUTINE_TESTS
+#define ATUL_COROUTINE_TESTS
+
+#include <atul/Coroutine.hpp>
+
+#ifdef ATUL_HAS_COROUTINES
+
+#include <atul/Allocators.hpp>
+
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace atul::tests {
+
+    //=====================================================
+    // Helper functions
+    //=====================================================
+
+    Task<int> coroutine_constant(int value) {
+        co_return value;
+    }
+
+    Task<int> coroutine_sum(int a, int b) {
+        const int x = co_await coroutine_constant(a);
+        const int y = co_await coroutine_constant(b);
+        co_return x + y;
+    }
+
+    Task<> coroutine_throw() {
+        throw std::runtime_error{"coroutine_throw"};
+        co_return;
+    }
+
+    Task<> coroutine_append(Event_loop& loop, std::vector<int>& order, int id) {
+        for (int i = 0; i < 3; ++i) {
+            order.push_back(id);
+            co_await loop.schedule();
+        }
+    }
+
+    template<class Alloc>
+    Task<int> coroutine_allocated_sum(std::allocator_arg_t, Alloc a, int depth) {
+        if (depth == 0) {
+            co_return 1;
+        }
+
+        const int x = co_await coroutine_allocated_sum(std::allocator_arg, a, depth - 1);
+        co_return x + 1;
+    }
+
+    //=====================================================
+    // Coroutine tests
+    //=====================================================
+
+    TEST(Coroutine_tests, Task_returns_value) {
+        Event_loop loop;
+        EXPECT_EQ(loop.run_until_complete(coroutine_constant(42)), 42);
+        EXPECT_EQ(loop.run_until_complete(coroutine_sum(2, 3)), 5);
+    }
+
+    TEST(Coroutine_tests, Task_propagates_exceptions) {
+        Event_loop loop;
+        EXPECT_THROW(loop.run_until_complete(coroutine_throw()), std::runtime_error);
+
+        auto catching = [] () -> Task<bool> {
+            try {
+                co_await coroutine_throw();
+            } catch (const std::runtime_error&) {
+                co_return true;
+            }
+            co_return false;
+        };
+
+        EXPECT_TRUE(loop.run_until_complete(catching()));
+    }
+
+    TEST(Coroutine_tests, Schedule_interleaves_spawned_tasks) {
+        Event_loop loop;
+        std::vector<int> order;
+
+        loop.spawn(coroutine_append(loop, order, 0));
+        loop.spawn(coroutine_append(loop, order, 1));
+        EXPECT_TRUE(order.empty());
+
+        loop.run();
+        EXPECT_EQ(order, (std::vector<int>{0, 1, 0, 1, 0, 1}));
+        EXPECT_TRUE(loop.empty());
+    }
+
+    TEST(Coroutine_tests, Await_callback) {
+        using callback_type = decltype(await_callback<int>([] (auto&&) {}))::callback_type;
+        static_assert(callback_type::small_buffer_size == 2 * sizeof(void*));
+
+        Event_loop loop;
+        std::vector<callback_type> pending;
+        int result = 0;
+
+        auto task = [&pending, &result] () -> Task<> {
+            const int x = co_await await_callback<int>([&pending] (callback_type callback) {
+                pending.push_back(std::move(callback));
+            });
+
+            co_await await_callback([] (SBO_unique_function<16, void()> callback) {
+                callback();
+            });
+
+            result = x * 2;
+        };
+
+        loop.spawn(task());
+        loop.run();
+        ASSERT_EQ(pending.size(), 1u);
+        EXPECT_EQ(result, 0);
+
+        pending.front()(21);
+        EXPECT_EQ(result, 42);
+    }
+
+    TEST(Coroutine_tests, Run_until_complete_without_work) {
+        Event_loop loop;
+        auto task = [] () -> Task<> {
+            co_await await_callback([] (SBO_unique_function<16, void()>) {});
+        };
+
+        EXPECT_THROW(loop.run_until_complete(task()), std::logic_error);
+    }
+
+    TEST(Coroutine_tests, Sleep_until) {
+        Event_loop loop;
+        Timer_wheel wheel;
+        std::vector<std::uint64_t> wakeups;
+
+        auto sleeper = [&wheel, &wakeups] (std::uint64_t deadline) -> Task<> {
+            co_await sleep_until(wheel, deadline);
+            wakeups.push_back(wheel.now());
+        };
+
+        loop.spawn(sleeper(100));
+        loop.spawn(sleeper(10));
+        loop.spawn(sleeper(0));
+        loop.run();
+        EXPECT_EQ(wakeups, (std::vector<std::uint64_t>{0}));
+
+        wheel.advance(50);
+        wheel.advance(1000);
+        EXPECT_EQ(wakeups, (std::vector<std::uint64_t>{0, 10, 100}));
+    }
+
+    TEST(Coroutine_tests, Frames_use_allocator) {
+        Counting_resource resource;
+        {
+            std::pmr::polymorphic_allocator<std::byte> allocator{&resource};
+            AA_SBO_event_loop<std::pmr::polymorphic_allocator<std::byte>, 32> loop{allocator};
+
+            EXPECT_EQ(loop.run_until_complete(coroutine_allocated_sum(std::allocator_arg, allocator, 7)), 8);
+            EXPECT_GE(resource.allocations, 8u);
+        }
+
+        EXPECT_EQ(resource.deallocations, resource.allocations);
+    }
+
+    TEST(Coroutine_tests, Pipeline_runs_out_of_arena) {
+        Counting_resource upstream;
+        {
+            std::pmr::monotonic_buffer_resource arena{&upstream};
+            Arena_allocator<std::byte> allocator{arena};
+            AA_SBO_event_loop<Arena_allocator<std::byte>, 32> loop{allocator};
+
+            for (int i = 0; i < 10; ++i) {
+                loop.spawn(coroutine_allocated_sum(std::allocator_arg, allocator, 5));
+            }
+            EXPECT_EQ(loop.run_until_complete(coroutine_allocated_sum(std::allocator_arg, allocator, 20)), 21);
+
+            EXPECT_GT(upstream.allocations, 0u);
+            EXPECT_EQ(upstream.deallocations, 0u);
+        }
+
+        EXPECT_EQ(upstream.deallocations, upstream.allocations);
+    }
+
+}
+
+#endif
+
+#endif
@@ -4,6 +4,11 @@
 #include <atul/Function.hpp>
 
 #include <memory_resource>
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace atul::tests {
 
@@ -111,6 +116,35 @@ namespace atul::tests {
         EXPECT_EQ(x5, 545);
     }
 
+    int x6 = 0;
+
+    TEST(Function_tests, Move_lambda) {
+        int y = 32;
+        auto lambda = [y] (int arg) {
+            x6 = arg + y;
+        };
+
+        Function<void(int)> function_original{lambda};
+        Function<void(int)> function_moved{std::move(function_original)};
+        function_moved(10);
+
+        EXPECT_EQ(x6, 42);
+        EXPECT_FALSE(function_original);
+        EXPECT_TRUE(function_moved);
+    }
+
+    TEST(Function_tests, Target) {
+        int y = 32;
+        auto lambda = [y] (int arg) {
+            return arg + y;
+        };
+
+        Function<int(int)> function{lambda};
+        EXPECT_EQ(function.target<int>(), nullptr);
+        ASSERT_NE(function.target<decltype(lambda)>(), nullptr);
+        EXPECT_EQ((*function.target<decltype(lambda)>())(10), 42);
+    }
+
     //=====================================================
     // AA_function Tests
     //=====================================================
@@ -278,6 +312,749 @@ namespace atul::tests {
         EXPECT_EQ(x2_5, 545);
     }
 
+    int x2_6 = 0;
+
+    TEST(SBO_function_tests, Copy_and_move_capturing_lambda) {
+        int y = 1;
+        auto lambda = [y] (int arg) {
+            x2_6 = arg + y;
+        };
+
+        SBO_function<24, void(int)> function_original{lambda};
+        SBO_function<24, void(int)> function_copy{function_original};
+        SBO_function<24, void(int)> function_moved{std::move(function_original)};
+
+        function_copy(10);
+        EXPECT_EQ(x2_6, 11);
+
+        function_moved(20);
+        EXPECT_EQ(x2_6, 21);
+
+        EXPECT_FALSE(function_original);
+    }
+
+    TEST(SBO_function_tests, Assign_large_lambda) {
+        std::array<int, 16> values{};
+        values[15] = 7;
+
+        auto lambda = [values] () {
+            return values[15];
+        };
+
+        SBO_function<16, int()> function;
+        function = lambda;
+        EXPECT_EQ(function(), 7);
+
+        SBO_function<16, int()> function_copy;
+        function_copy = function;
+        EXPECT_EQ(function_copy(), 7);
+
+        function = nullptr;
+        EXPECT_FALSE(function);
+    }
+
+    TEST(SBO_function_tests, Throwing_copy_assignment_leaves_target_unchanged) {
+        struct Throwing_copy {
+            bool throw_on_copy = false;
+
+            Throwing_copy() = default;
+
+            Throwing_copy(const Throwing_copy& other):
+                throw_on_copy(other.throw_on_copy) {
+                if (throw_on_copy) {
+                    throw std::runtime_error{"copy"};
+                }
+            }
+
+            Throwing_copy(Throwing_copy&&) noexcept = default;
+
+            int operator()() const {
+                return 1;
+            }
+        };
+
+        SBO_function<32, int()> source{Throwing_copy{}};
+        source.target<Throwing_copy>()->throw_on_copy = true;
+
+        SBO_function<32, int()> function{[] () { return 2; }};
+        EXPECT_THROW(function = source, std::runtime_error);
+        EXPECT_EQ(function(), 2);
+
+        static_assert(!std::is_nothrow_copy_assignable_v<SBO_function<32, int()>>);
+    }
+
+    //=====================================================
+    // Unique_function Tests
+    //=====================================================
+
+    static_assert(!std::is_copy_constructible_v<Unique_function<void()>>);
+    static_assert(!std::is_copy_assignable_v<Unique_function<void()>>);
+    static_assert(std::is_nothrow_move_constructible_v<Unique_function<void()>>);
+    static_assert(!std::is_copy_constructible_v<SBO_unique_function<32, void()>>);
+
+    TEST(Unique_function_tests, Move_only_lambda) {
+        auto ptr = std::make_unique<int>(17);
+        auto lambda = [ptr = std::move(ptr)] (int arg) {
+            return *ptr + arg;
+        };
+
+        Unique_function<int(int)> function{std::move(lambda)};
+        EXPECT_EQ(function(3), 20);
+
+        Unique_function<int(int)> function_moved{std::move(function)};
+        EXPECT_EQ(function_moved(4), 21);
+        EXPECT_FALSE(function);
+    }
+
+    struct Owning_functor {
+        std::unique_ptr<int> ptr;
+
+        int operator()() {
+            return *ptr;
+        }
+    };
+
+}
+
+template<>
+struct atul::is_trivially_relocatable<atul::tests::Owning_functor> : std::true_type {};
+
+namespace atul::tests {
+
+    TEST(Unique_function_tests, Move_only_functor_in_small_buffer) {
+        SBO_unique_function<32, int()> function{Owning_functor{std::make_unique<int>(17)}};
+        EXPECT_EQ(function(), 17);
+
+        SBO_unique_function<32, int()> function_moved;
+        function_moved = std::move(function);
+        EXPECT_EQ(function_moved(), 17);
+    }
+
+    TEST(Unique_function_tests, Copyable_lambda) {
+        int y = 5;
+        SBO_unique_function<16, int()> function{[y] () { return y; }};
+        EXPECT_EQ(function(), 5);
+    }
+
+    //=====================================================
+    // Function_ref Tests
+    //=====================================================
+
+    static_assert(sizeof(Function_ref<void()>) == 2 * sizeof(void*));
+
+    int x3_0 = 0;
+
+    void foo3_0(int arg) {
+        x3_0 = arg;
+    }
+
+    TEST(Function_ref_tests, Function_pointer) {
+        Function_ref<void(int)> function{foo3_0};
+        function(15);
+
+        EXPECT_EQ(x3_0, 15);
+
+        Function_ref<void(int)> function_from_pointer{&foo3_0};
+        function_from_pointer(16);
+
+        EXPECT_EQ(x3_0, 16);
+    }
+
+    TEST(Function_ref_tests, Null_pointers_are_empty) {
+        struct Widget {
+            int value = 4;
+        };
+
+        void (*null_function)(int) = nullptr;
+        Function_ref<void(int)> function{null_function};
+        EXPECT_FALSE(function);
+        EXPECT_THROW(function(1), std::bad_function_call);
+
+        int Widget::* null_member = nullptr;
+        Function_ref<int(Widget&)> member{null_member};
+        EXPECT_FALSE(member);
+
+        int Widget::* value = &Widget::value;
+        Function_ref<int(Widget&)> valid_member{value};
+        Widget widget;
+        EXPECT_TRUE(valid_member);
+        EXPECT_EQ(valid_member(widget), 4);
+        EXPECT_TRUE(Function_ref<void(int)>{foo3_0});
+    }
+
+    TEST(Function_ref_tests, Lambda_is_referenced) {
+        int count = 0;
+        auto lambda = [&count] (int arg) {
+            return count += arg;
+        };
+
+        Function_ref<int(int)> function{lambda};
+        EXPECT_EQ(function(5), 5);
+        EXPECT_EQ(function(5), 10);
+
+        Function_ref<int(int)> function_copy{function};
+        EXPECT_EQ(function_copy(1), 11);
+        EXPECT_EQ(count, 11);
+    }
+
+    TEST(Function_ref_tests, Stateful_functor_is_not_copied) {
+        struct Counter {
+            int count = 0;
+
+            int operator()() {
+                return ++count;
+            }
+        };
+
+        Counter counter;
+        Function_ref<int()> function{counter};
+        function();
+        function();
+
+        EXPECT_EQ(counter.count, 2);
+    }
+
+    TEST(Function_ref_tests, From_AA_SBO_function) {
+        int y = 3;
+        SBO_function<16, int(int)> sbo_function{[y] (int arg) { return arg * y; }};
+        Function<int(int)> function{[y] (int arg) { return arg + y; }};
+
+        Function_ref<int(int)> sbo_ref{sbo_function};
+        Function_ref<int(int)> function_ref{function};
+
+        EXPECT_EQ(sbo_ref(5), 15);
+        EXPECT_EQ(function_ref(5), 8);
+    }
+
+    TEST(Function_ref_tests, Empty_AA_SBO_function) {
+        Function<void()> function;
+        Function_ref<void()> function_ref{function};
+
+        EXPECT_THROW(function_ref(), std::bad_function_call);
+    }
+
+    //=====================================================
+    // Relocation Tests
+    //=====================================================
+
+    static_assert(is_trivially_relocatable_v<Function<void()>>);
+    static_assert(is_trivially_relocatable_v<Unique_function<void()>>);
+    static_assert(!is_trivially_relocatable_v<SBO_function<32, void()>>);
+    static_assert(!is_trivially_relocatable_v<SBO_unique_function<32, void()>>);
+
+    TEST(Relocation_tests, Vector_growth) {
+        std::vector<SBO_function<16, int()>> functions;
+        for (int i = 0; i < 100; ++i) {
+            if (i % 2) {
+                functions.emplace_back([i] () { return i; });
+            } else {
+                std::array<int, 8> values{};
+                values[0] = i;
+                functions.emplace_back([values] () { return values[0]; });
+            }
+        }
+
+        for (int i = 0; i < 100; ++i) {
+            EXPECT_EQ(functions[i](), i);
+        }
+    }
+
+    TEST(Relocation_tests, Non_trivially_relocatable_callables_stay_inline) {
+        std::string text = "a string too long for the short string optimization";
+        auto string_lambda = [text] () { return text.size(); };
+        auto shared_lambda = [ptr = std::make_shared<std::size_t>(7)] () { return *ptr; };
+        auto unique_lambda = [ptr = std::make_unique<std::size_t>(9)] () { return *ptr; };
+
+        static_assert(SBO_function<64, std::size_t()>::stores_inline<decltype(string_lambda)>);
+        static_assert(SBO_function<64, std::size_t()>::stores_inline<decltype(shared_lambda)>);
+        static_assert(SBO_unique_function<64, std::size_t()>::stores_inline<decltype(unique_lambda)>);
+
+        using function_type = SBO_unique_function<64, std::size_t()>;
+        function_type a{string_lambda};
+        function_type b{std::move(unique_lambda)};
+
+        function_type moved{std::move(a)};
+        EXPECT_FALSE(a);
+        EXPECT_EQ(moved(), text.size());
+
+        a = std::move(b);
+        EXPECT_EQ(a(), 9u);
+
+        swap(a, moved);
+        EXPECT_EQ(a(), text.size());
+        EXPECT_EQ(moved(), 9u);
+
+        std::array<long, 32> large{};
+        large[0] = 3;
+        function_type allocated{[large] () { return static_cast<std::size_t>(large[0]); }};
+        swap(allocated, a);
+        EXPECT_EQ(allocated(), text.size());
+        EXPECT_EQ(a(), 3u);
+
+        std::vector<SBO_function<64, std::size_t()>> functions;
+        for (int i = 0; i < 50; ++i) {
+            functions.emplace_back(i % 2 ? SBO_function<64, std::size_t()>{string_lambda} : SBO_function<64, std::size_t()>{shared_lambda});
+        }
+        for (int i = 0; i < 50; ++i) {
+            EXPECT_EQ(functions[i](), i % 2 ? text.size() : 7u);
+        }
+    }
+
+    TEST(Relocation_tests, Uninitialized_relocate) {
+        using function_type = SBO_function<16, int()>;
+        constexpr int n = 4;
+
+        alignas(function_type) std::byte source_storage[n * sizeof(function_type)];
+        alignas(function_type) std::byte dest_storage[n * sizeof(function_type)];
+
+        auto* source = reinterpret_cast<function_type*>(source_storage);
+        auto* dest = reinterpret_cast<function_type*>(dest_storage);
+
+        std::array<int, 8> values{};
+        for (int i = 0; i < n; ++i) {
+            values[0] = i * 10;
+            if (i % 2) {
+                new (source + i) function_type{[i] () { return i * 10; }};
+            } else {
+                new (source + i) function_type{[values] () { return values[0]; }};
+            }
+        }
+
+        function_type* end = uninitialized_relocate(source, source + n, dest);
+        EXPECT_EQ(end, dest + n);
+
+        for (int i = 0; i < n; ++i) {
+            EXPECT_EQ(dest[i](), i * 10);
+            dest[i].~function_type();
+        }
+    }
+
+    //=====================================================
+    // Qualified signature Tests
+    //=====================================================
+
+    struct Counting_functor {
+        int count = 0;
+
+        int operator()() {
+            return ++count;
+        }
+    };
+
+    struct Const_functor {
+        int operator()() const {
+            return 7;
+        }
+    };
+
+    struct Throwing_functor {
+        int operator()() const {
+            throw std::runtime_error{"call"};
+        }
+    };
+
+    struct Nothrow_functor {
+        int operator()() const noexcept {
+            return 9;
+        }
+    };
+
+    static_assert(Signature_traits<int() const>::is_compatible<Const_functor>);
+    static_assert(!Signature_traits<int() const>::is_compatible<Counting_functor>);
+    static_assert(Signature_traits<int() noexcept>::is_compatible<Nothrow_functor>);
+    static_assert(!Signature_traits<int() noexcept>::is_compatible<Throwing_functor>);
+    static_assert(!Signature_traits<int() const noexcept>::is_compatible<Counting_functor>);
+
+    static_assert(!noexcept(std::declval<Function<int()>&>()()));
+    static_assert(noexcept(std::declval<Function<int() noexcept>&>()()));
+    static_assert(noexcept(std::declval<const Function<int() const noexcept>&>()()));
+    static_assert(std::is_invocable_v<const Function<int() const>&>);
+    static_assert(!std::is_invocable_v<const Function<int()>&>);
+    static_assert(!std::is_invocable_v<const Function<int() noexcept>&>);
+
+    TEST(Qualified_signature_tests, Const_call) {
+        const SBO_function<16, int() const> function{Const_functor{}};
+        EXPECT_EQ(function(), 7);
+
+        const Function<int() const> empty;
+        EXPECT_THROW(empty(), std::bad_function_call);
+    }
+
+    TEST(Qualified_signature_tests, Noexcept_call) {
+        Function<int() noexcept> function{Nothrow_functor{}};
+        EXPECT_EQ(function(), 9);
+
+        SBO_function<16, int(int) noexcept> lambda{[] (int x) noexcept { return x * 2; }};
+        EXPECT_EQ(lambda(21), 42);
+    }
+
+    TEST(Qualified_signature_tests, Const_noexcept_copy_and_move) {
+        std::array<int, 16> values{};
+        values[15] = 5;
+        auto callable = [values] () noexcept { return values[15]; };
+
+        SBO_function<16, int() const noexcept> a{callable};
+        SBO_function<16, int() const noexcept> b{a};
+        SBO_function<16, int() const noexcept> c{std::move(a)};
+
+        EXPECT_FALSE(a);
+        EXPECT_EQ(b(), 5);
+        EXPECT_EQ(c(), 5);
+    }
+
+    TEST(Qualified_signature_tests, Move_only_noexcept) {
+        SBO_unique_function<16, int() noexcept> function{[p = std::make_unique<int>(4)] () noexcept { return *p; }};
+        SBO_unique_function<16, int() noexcept> moved{std::move(function)};
+        EXPECT_EQ(moved(), 4);
+    }
+
+    //=====================================================
+    // Parameter passing Tests
+    //=====================================================
+
+    static_assert(std::is_same_v<forwarded_parameter_t<int>, int>);
+    static_assert(std::is_same_v<forwarded_parameter_t<int*>, int*>);
+    static_assert(std::is_same_v<forwarded_parameter_t<std::string>, std::string&&>);
+    static_assert(std::is_same_v<forwarded_parameter_t<std::array<int, 16>>, std::array<int, 16>&&>);
+    static_assert(std::is_same_v<forwarded_parameter_t<const int&>, const int&>);
+    static_assert(std::is_same_v<shared_parameter_t<int>, int>);
+    static_assert(std::is_same_v<shared_parameter_t<std::string>, std::string&>);
+
+    TEST(Parameter_passing_tests, Lvalue_scalar_argument) {
+        Function<int(int)> function{[] (int x) { return x + 1; }};
+
+        int x = 4;
+        EXPECT_EQ(function(x), 5);
+        EXPECT_EQ(x, 4);
+    }
+
+    TEST(Parameter_passing_tests, Non_trivial_argument_is_moved) {
+        Function<std::string(std::string)> function{[] (std::string s) { return s; }};
+
+        std::string str(64, 'a');
+        EXPECT_EQ(function(std::move(str)), std::string(64, 'a'));
+        EXPECT_TRUE(str.empty());
+    }
+
+    TEST(Parameter_passing_tests, Reference_argument) {
+        Function<void(int&)> function{[] (int& x) { x = 8; }};
+
+        int x = 0;
+        function(x);
+        EXPECT_EQ(x, 8);
+    }
+
+    //=====================================================
+    // Layout Tests
+    //=====================================================
+
+    // Stateless allocators take up no space
+    static_assert(sizeof(Function<void()>) == 3 * sizeof(void*));
+    static_assert(sizeof(SBO_function<16, void()>) == 2 * sizeof(void*) + 16);
+    static_assert(sizeof(AA_SBO_function<Pool_allocator<std::byte>, 16, void()>) == 2 * sizeof(void*) + 16);
+
+    // Stateful allocators take up only their own size, plus padding ahead of
+    // the small buffer
+    static_assert(sizeof(AA_SBO_function<std::pmr::polymorphic_allocator<std::byte>, 16, void()>) == compute_sbo_size(3 * sizeof(void*), alignof(std::max_align_t)) + 16);
+
+    TEST(Layout_tests, Stateful_allocator_is_preserved) {
+        std::pmr::monotonic_buffer_resource resource;
+        AA_SBO_function<std::pmr::polymorphic_allocator<std::byte>, 16, int()> function{&resource, [] () { return 3; }};
+        AA_SBO_function<std::pmr::polymorphic_allocator<std::byte>, 16, int()> moved{std::move(function)};
+
+        EXPECT_EQ(moved.get_allocator().resource(), &resource);
+        EXPECT_EQ(moved(), 3);
+    }
+
+    //=====================================================
+    // Function_statistics Tests
+    //=====================================================
+
+    TEST(Function_statistics_tests, Sbo_hits_and_misses) {
+        using function_type = AA_SBO_function<std::allocator<std::byte>, 16, int(), true, Function_statistics_observer>;
+        Function_statistics& stats = Function_statistics_observer::statistics<function_type>();
+        stats.reset();
+
+        int y = 4;
+        std::array<int, 16> values{};
+        values[0] = 5;
+
+        {
+            function_type small{[y] () { return y; }};
+            function_type large{[values] () { return values[0]; }};
+            function_type large_copy{large};
+            function_type large_moved{std::move(large)};
+
+            EXPECT_EQ(stats.sbo_hits.load(), 1u);
+            EXPECT_EQ(stats.sbo_misses.load(), 2u);
+            EXPECT_GE(stats.heap_bytes.load(), 2 * sizeof(values));
+            EXPECT_EQ(stats.live_heap_bytes.load(), stats.heap_bytes.load());
+            EXPECT_EQ(stats.live_wrappers.load(), 3u);
+        }
+
+        EXPECT_EQ(stats.live_heap_bytes.load(), 0u);
+        EXPECT_EQ(stats.live_wrappers.load(), 0u);
+        EXPECT_EQ(stats.peak_live_wrappers.load(), 3u);
+    }
+
+    //=====================================================
+    // Small buffer sizing Tests
+    //=====================================================
+
+    struct Small_functor {
+        int a;
+
+        int operator()() {
+            return a;
+        }
+    };
+
+    struct Large_functor {
+        double a;
+        double b;
+        double c;
+
+        int operator()() {
+            return static_cast<int>(a + b + c);
+        }
+    };
+
+    struct Over_aligned_functor {
+        alignas(64) int a;
+
+        int operator()() {
+            return a;
+        }
+    };
+
+    struct Non_relocatable_functor {
+        Non_relocatable_functor() = default;
+
+        Non_relocatable_functor(const Non_relocatable_functor&) {}
+
+        int operator()() {
+            return 0;
+        }
+    };
+
+    static_assert(recommended_sbo_size_v<int(), Small_functor> == sizeof(Small_functor));
+    static_assert(recommended_sbo_size_v<int(), Small_functor, Large_functor> == sizeof(Large_functor));
+
+    static_assert(stores_inline_v<SBO_function<recommended_sbo_size_v<int(), Small_functor, Large_functor>, int()>, Small_functor>);
+    static_assert(stores_inline_v<SBO_function<recommended_sbo_size_v<int(), Small_functor, Large_functor>, int()>, Large_functor>);
+    static_assert(!stores_inline_v<SBO_function<sizeof(Large_functor) - alignof(void*), int()>, Large_functor>);
+
+    static_assert(!stores_inline_v<Function<int()>, Small_functor>);
+    static_assert(!stores_inline_v<SBO_function<128, int()>, Over_aligned_functor>);
+    static_assert(!stores_inline_v<SBO_function<128, int()>, Non_relocatable_functor>);
+
+    TEST(Small_buffer_sizing_tests, Recommended_size_avoids_allocation) {
+        using function_type = AA_SBO_function<
+            std::allocator<std::byte>,
+            recommended_sbo_size_v<int(), Small_functor, Large_functor>,
+            int(),
+            true,
+            Function_statistics_observer
+        >;
+
+        Function_statistics& stats = Function_statistics_observer::statistics<function_type>();
+        stats.reset();
+
+        function_type small{Small_functor{3}};
+        function_type large{Large_functor{1.0, 2.0, 3.0}};
+
+        EXPECT_EQ(small(), 3);
+        EXPECT_EQ(large(), 6);
+        EXPECT_EQ(stats.sbo_misses.load(), 0u);
+        EXPECT_EQ(stats.sbo_hits.load(), 2u);
+    }
+
+    //=====================================================
+    // Stateless callable Tests
+    //=====================================================
+
+    int add_one(int x) {
+        return x + 1;
+    }
+
+    inline const auto captureless_lambda = [] (int x) { return x * 2; };
+
+    using Captureless_lambda = std::remove_const_t<decltype(captureless_lambda)>;
+
+    static_assert(is_stateless_callable_v<int (*)(int)>);
+    static_assert(is_stateless_callable_v<Captureless_lambda>);
+    static_assert(!is_stateless_callable_v<Small_functor>);
+
+    static_assert(stores_inline_v<Function<int(int)>, int (*)(int)>);
+    static_assert(stores_inline_v<Function<int(int)>, int (&)(int)>);
+    static_assert(stores_inline_v<Unique_function<int(int)>, Captureless_lambda>);
+    static_assert(recommended_sbo_size_v<int(int), int (*)(int), Captureless_lambda> == 0);
+
+    TEST(Stateless_callable_tests, Never_allocate) {
+        using function_type = AA_SBO_function<std::allocator<std::byte>, 0, int(int), true, Function_statistics_observer>;
+        Function_statistics& stats = Function_statistics_observer::statistics<function_type>();
+        stats.reset();
+
+        {
+            function_type pointer{add_one};
+            function_type lambda{[] (int x) { return x * 2; }};
+            function_type pointer_copy{pointer};
+            function_type lambda_copy{lambda};
+            function_type lambda_moved{std::move(lambda)};
+
+            EXPECT_EQ(pointer_copy(1), 2);
+            EXPECT_EQ(lambda_copy(3), 6);
+            EXPECT_EQ(lambda_moved(4), 8);
+            EXPECT_EQ(stats.sbo_misses.load(), 0u);
+            EXPECT_EQ(stats.heap_bytes.load(), 0u);
+        }
+
+        EXPECT_EQ(stats.live_wrappers.load(), 0u);
+    }
+
+    TEST(Stateless_callable_tests, Null_function_pointer_is_empty) {
+        int (*pointer)(int) = nullptr;
+
+        Function<int(int)> function{pointer};
+        EXPECT_FALSE(function);
+
+        function = add_one;
+        EXPECT_EQ(function(1), 2);
+
+        function = pointer;
+        EXPECT_FALSE(function);
+        EXPECT_THROW(function(1), std::bad_function_call);
+    }
+
+
+    //=====================================================
+    // Alignment Tests
+    //=====================================================
+
+    static_assert(SBO_function<16, int()>::small_buffer_alignment == alignof(std::max_align_t));
+    static_assert(stores_inline_v<Aligned_SBO_function<64, 64, int()>, Over_aligned_functor>);
+    static_assert(alignof(Aligned_SBO_function<64, 64, int()>) == 64);
+
+    TEST(Alignment_tests, Over_aligned_inline_callable) {
+        Aligned_SBO_function<64, 64, int()> function{Over_aligned_functor{5}};
+        auto* target = function.target<Over_aligned_functor>();
+
+        ASSERT_NE(target, nullptr);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(target) % 64, 0u);
+        EXPECT_EQ(function(), 5);
+
+        Aligned_SBO_function<64, 64, int()> moved{std::move(function)};
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(moved.target<Over_aligned_functor>()) % 64, 0u);
+        EXPECT_EQ(moved(), 5);
+    }
+
+    TEST(Alignment_tests, Over_aligned_allocated_callable) {
+        std::pmr::monotonic_buffer_resource resource;
+        std::pmr::polymorphic_allocator<std::byte> allocator{&resource};
+
+        // Misalign the resource's next allocation
+        static_cast<void>(allocator.allocate(1));
+
+        pmr::SBO_function<16, int()> function{allocator, Over_aligned_functor{6}};
+        pmr::SBO_function<16, int()> copy{function};
+
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(function.target<Over_aligned_functor>()) % 64, 0u);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(copy.target<Over_aligned_functor>()) % 64, 0u);
+        EXPECT_EQ(copy(), 6);
+    }
+
+
+    //=====================================================
+    // In-place construction Tests
+    //=====================================================
+
+    struct Move_counting_functor {
+        static inline int moves = 0;
+
+        std::array<int, 4> values;
+
+        Move_counting_functor(int a, int b):
+            values{a, b, 0, 0} {}
+
+        Move_counting_functor(const Move_counting_functor&) = default;
+
+        Move_counting_functor(Move_counting_functor&& other) noexcept:
+            values(other.values)
+        {
+            ++moves;
+        }
+
+        int operator()() const {
+            return values[0] + values[1];
+        }
+    };
+
+}
+
+template<>
+struct atul::is_trivially_relocatable<atul::tests::Move_counting_functor> : std::true_type {};
+
+namespace atul::tests {
+
+    struct Immovable_functor {
+        int value;
+
+        explicit Immovable_functor(int v):
+            value(v) {}
+
+        Immovable_functor(Immovable_functor&&) = delete;
+
+        int operator()() const {
+            return value;
+        }
+    };
+
+    TEST(In_place_tests, Construct_without_moving) {
+        Move_counting_functor::moves = 0;
+
+        static_assert(stores_inline_v<SBO_function<64, int()>, Move_counting_functor>);
+        static_assert(!stores_inline_v<Function<int()>, Move_counting_functor>);
+
+        SBO_function<64, int()> inline_function{std::in_place_type<Move_counting_functor>, 2, 3};
+        Function<int()> allocated_function{std::in_place_type<Move_counting_functor>, 4, 5};
+
+        EXPECT_EQ(inline_function(), 5);
+        EXPECT_EQ(allocated_function(), 9);
+        EXPECT_EQ(Move_counting_functor::moves, 0);
+    }
+
+    TEST(In_place_tests, Immovable_callable) {
+        Unique_function<int()> function{std::in_place_type<Immovable_functor>, 7};
+        Unique_function<int()> moved{std::move(function)};
+
+        EXPECT_FALSE(function);
+        EXPECT_EQ(moved(), 7);
+    }
+
+    TEST(In_place_tests, Emplace_replaces_callable) {
+        Move_counting_functor::moves = 0;
+
+        SBO_unique_function<64, int()> function{[] () { return 1; }};
+        Move_counting_functor& functor = function.emplace<Move_counting_functor>(6, 1);
+        EXPECT_EQ(function(), 7);
+
+        functor.values[0] = 10;
+        EXPECT_EQ(function(), 11);
+
+        Immovable_functor& immovable = function.emplace<Immovable_functor>(3);
+        EXPECT_EQ(&immovable, function.target<Immovable_functor>());
+        EXPECT_EQ(function(), 3);
+        EXPECT_EQ(Move_counting_functor::moves, 0);
+    }
+
+    TEST(In_place_tests, Allocator_extended) {
+        std::pmr::monotonic_buffer_resource resource;
+
+        pmr::Unique_function<int()> function{std::allocator_arg, &resource, std::in_place_type<Immovable_functor>, 8};
+        EXPECT_EQ(function.get_allocator().resource(), &resource);
+        EXPECT_EQ(function(), 8);
+    }
+
 }
 
 #endif
@@ -0,0 +1,196 @@
+#ifndef ATUL_FUNCTION_VECTOR_TESTS
+#define ATUL_FUNCTION_VECTOR_TESTS
+
+#include <atul/Function_vector.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace atul::tests {
+
+    //=====================================================
+    // Function_vector tests
+    //=====================================================
+
+    TEST(Function_vector_tests, Empty) {
+        Function_vector<void(int)> functions;
+        functions.invoke_all(5);
+
+        EXPECT_TRUE(functions.empty());
+        EXPECT_EQ(functions.size(), 0u);
+        EXPECT_EQ(functions.group_count(), 0u);
+    }
+
+    int x4_0 = 0;
+
+    void foo4_0(int arg) {
+        x4_0 += arg;
+    }
+
+    TEST(Function_vector_tests, Groups_by_type) {
+        int sum = 0;
+        auto add = [&sum] (int arg) { sum += arg; };
+        auto add_twice = [&sum] (int arg) { sum += 2 * arg; };
+
+        Function_vector<void(int)> functions;
+        for (int i = 0; i < 100; ++i) {
+            functions.push_back(add);
+            functions.push_back(add_twice);
+        }
+        functions.push_back(&foo4_0);
+
+        EXPECT_EQ(functions.size(), 201u);
+        EXPECT_EQ(functions.group_count(), 3u);
+
+        x4_0 = 0;
+        functions.invoke_all(1);
+
+        EXPECT_EQ(sum, 300);
+        EXPECT_EQ(x4_0, 1);
+    }
+
+    TEST(Function_vector_tests, Insertion_order_within_group) {
+        std::vector<int> order;
+
+        Function_vector<void()> functions;
+        for (int i = 0; i < 50; ++i) {
+            functions.push_back([&order, i] () { order.push_back(i); });
+        }
+
+        functions.invoke_all();
+
+        ASSERT_EQ(order.size(), 50u);
+        for (int i = 0; i < 50; ++i) {
+            EXPECT_EQ(order[i], i);
+        }
+    }
+
+    TEST(Function_vector_tests, Non_trivial_callables) {
+        auto count = std::make_shared<int>(0);
+        std::string suffix = "a string long enough to not be stored inline by std::string";
+
+        {
+            Function_vector<void(std::string&)> functions;
+            for (int i = 0; i < 20; ++i) {
+                functions.push_back([count, suffix] (std::string& s) {
+                    ++*count;
+                    s = suffix;
+                });
+            }
+
+            EXPECT_EQ(count.use_count(), 21);
+
+            std::string s;
+            functions.invoke_all(s);
+
+            EXPECT_EQ(*count, 20);
+            EXPECT_EQ(s, suffix);
+
+            Function_vector<void(std::string&)> functions_moved{std::move(functions)};
+            EXPECT_EQ(functions_moved.size(), 20u);
+            EXPECT_TRUE(functions.empty());
+        }
+
+        EXPECT_EQ(count.use_count(), 1);
+    }
+
+    TEST(Function_vector_tests, Emplace) {
+        struct Accumulator {
+            explicit Accumulator(int s): step(s) {}
+
+            int step;
+
+            void operator()(int& total) const {
+                total += step;
+            }
+        };
+
+        Function_vector<void(int&)> functions;
+        Accumulator& a = functions.emplace<Accumulator>(3);
+        EXPECT_EQ(a.step, 3);
+        functions.emplace<Accumulator>(4);
+
+        int total = 0;
+        functions.invoke_all(total);
+        EXPECT_EQ(total, 7);
+    }
+
+    TEST(Function_vector_tests, Failed_allocation_adds_no_group) {
+        class Failing_resource : public std::pmr::memory_resource {
+        public:
+            bool fail = false;
+
+        private:
+            void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+                if (fail) {
+                    throw std::bad_alloc{};
+                }
+
+                return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+            }
+
+            void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+                std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+            }
+
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+        };
+
+        Failing_resource resource;
+        AA_function_vector<std::pmr::polymorphic_allocator<std::byte>, void(int&)> functions{&resource};
+        functions.push_back([] (int& x) { x += 1; });
+        functions.push_back([] (int& x) { x += 10; });
+        functions.push_back([] (int& x) { x += 100; });
+        ASSERT_EQ(functions.group_count(), 3u);
+
+        resource.fail = true;
+        EXPECT_THROW(functions.push_back([] (int& x) { x += 1000; }), std::bad_alloc);
+        EXPECT_EQ(functions.group_count(), 3u);
+        EXPECT_EQ(functions.size(), 3u);
+
+        int total = 0;
+        functions.invoke_all(total);
+        EXPECT_EQ(total, 111);
+    }
+
+    TEST(Function_vector_tests, Group_storage_is_aligned) {
+        struct alignas(std::max_align_t) Aligned_callable {
+            std::byte payload[1];
+
+            void operator()(int& count) const {
+                ++count;
+            }
+        };
+
+        std::pmr::monotonic_buffer_resource arena;
+        std::pmr::polymorphic_allocator<std::byte> allocator{&arena};
+        AA_function_vector<std::pmr::polymorphic_allocator<std::byte>, void(int&)> functions{allocator};
+        int misaligned = 0;
+        for (int i = 0; i < 20; ++i) {
+            // Odd-sized callables leave the arena's cursor misaligned
+            functions.push_back([a = char(i), b = char(i), c = char(i)] (int&) {
+                static_cast<void>(a + b + c);
+            });
+
+            // Read back through volatile so the check isn't folded away on
+            // the strength of the declared alignment
+            volatile std::uintptr_t address = reinterpret_cast<std::uintptr_t>(&functions.emplace<Aligned_callable>());
+            misaligned += (address % alignof(std::max_align_t) != 0);
+        }
+
+        EXPECT_EQ(misaligned, 0);
+
+        int count = 0;
+        functions.invoke_all(count);
+        EXPECT_EQ(count, 20);
+    }
+
+}
+
+#endif
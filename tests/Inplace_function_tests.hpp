@@ -0,0 +1,136 @@
+#ifndef ATUL_INPLACE_FUNCTION_TESTS
+#define ATUL_INPLACE_FUNCTION_TESTS
+
+#include <atul/Inplace_function.hpp>
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace atul::tests {
+
+    //=====================================================
+    // Inplace_function tests
+    //=====================================================
+
+    template<class F, class = void>
+    struct has_allocator_type : std::false_type {};
+
+    template<class F>
+    struct has_allocator_type<F, std::void_t<typename F::allocator_type>> : std::true_type {};
+
+    template<std::size_t N>
+    struct Sized_functor {
+        std::array<std::byte, N> payload{};
+
+        int operator()() const {
+            return static_cast<int>(N);
+        }
+    };
+
+    // No allocator, and nothing but an operations pointer and the buffer
+    static_assert(!has_allocator_type<Inplace_function<32, int()>>::value);
+    static_assert(sizeof(Inplace_function<32, int()>) == sizeof(void*) + 32);
+    static_assert(sizeof(Inplace_function<20, int()>) == sizeof(void*) + 24);
+
+    // Callables which don't fit are rejected at compile time
+    static_assert(std::is_constructible_v<Inplace_function<32, int()>, Sized_functor<32>>);
+    static_assert(!std::is_constructible_v<Inplace_function<32, int()>, Sized_functor<33>>);
+    static_assert(!std::is_assignable_v<Inplace_function<32, int()>&, Sized_functor<33>>);
+
+    struct alignas(32) Over_aligned_inplace_functor {
+        int operator()() const {
+            return 0;
+        }
+    };
+
+    static_assert(!std::is_constructible_v<Inplace_function<64, int()>, Over_aligned_inplace_functor>);
+
+    TEST(Inplace_function_tests, Default_constructed_is_empty) {
+        Inplace_function<16, int()> function;
+        EXPECT_FALSE(function);
+        EXPECT_THROW(function(), std::bad_function_call);
+    }
+
+    TEST(Inplace_function_tests, Invoke) {
+        Inplace_function<16, int(int, int)> function{[] (int a, int b) { return a * b; }};
+        EXPECT_EQ(function(6, 7), 42);
+    }
+
+    TEST(Inplace_function_tests, Buffer_filled_exactly) {
+        using function_type = Inplace_function<32, int()>;
+        function_type function{Sized_functor<32>{}};
+        EXPECT_EQ(function(), 32);
+        EXPECT_NE(function.target<Sized_functor<32>>(), nullptr);
+    }
+
+    TEST(Inplace_function_tests, Non_trivially_relocatable_callables) {
+        std::string text = "a string long enough to live on the heap";
+
+        Inplace_function<48, std::size_t()> a{[text] () { return text.size(); }};
+        Inplace_function<48, std::size_t()> b{a};
+        Inplace_function<48, std::size_t()> c{std::move(a)};
+
+        EXPECT_FALSE(a);
+        EXPECT_EQ(b(), text.size());
+        EXPECT_EQ(c(), text.size());
+
+        a = c;
+        EXPECT_EQ(a(), text.size());
+    }
+
+    TEST(Inplace_function_tests, Move_only_callables) {
+        Inplace_unique_function<16, int()> a{[p = std::make_unique<int>(3)] () { return *p; }};
+        Inplace_unique_function<16, int()> b{std::move(a)};
+        EXPECT_FALSE(a);
+        EXPECT_EQ(b(), 3);
+
+        static_assert(!std::is_copy_constructible_v<Inplace_unique_function<16, int()>>);
+    }
+
+    TEST(Inplace_function_tests, Destruction) {
+        auto owner = std::make_shared<int>(0);
+
+        {
+            Inplace_function<32, void()> a{[owner] () {}};
+            Inplace_function<32, void()> b{a};
+            EXPECT_EQ(owner.use_count(), 3);
+
+            b = nullptr;
+            EXPECT_EQ(owner.use_count(), 2);
+
+            a.swap(b);
+            EXPECT_FALSE(a);
+            EXPECT_TRUE(b);
+        }
+
+        EXPECT_EQ(owner.use_count(), 1);
+    }
+
+    TEST(Inplace_function_tests, Null_pointers_are_empty) {
+        struct Widget {
+            int value = 4;
+        };
+
+        int (*null_function)(int) = nullptr;
+        Inplace_function<16, int(int)> function{null_function};
+        EXPECT_FALSE(function);
+        EXPECT_THROW(function(1), std::bad_function_call);
+
+        int Widget::* null_member = nullptr;
+        Inplace_function<16, int(Widget&)> member{null_member};
+        EXPECT_FALSE(member);
+
+        member = &Widget::value;
+        Widget widget;
+        EXPECT_TRUE(member);
+        EXPECT_EQ(member(widget), 4);
+
+        member = null_member;
+        EXPECT_FALSE(member);
+    }
+
+}
+
+#endif
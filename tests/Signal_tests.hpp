@@ -0,0 +1,235 @@
+#ifndef ATUL_SIGNAL_TESTS
+#define ATUL_SIGNAL_TESTS
+
+#include <atul/Signal.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace atul::tests {
+
+    //=====================================================
+    // Signal tests
+    //=====================================================
+
+    TEST(Signal_tests, Emit_without_slots) {
+        Signal<void(int)> signal;
+        signal.emit(5);
+
+        EXPECT_EQ(signal.size(), 0u);
+    }
+
+    TEST(Signal_tests, Connect_and_emit) {
+        int sum = 0;
+
+        Signal<void(int)> signal;
+        signal.connect([&sum] (int x) { sum += x; });
+        signal.connect([&sum] (int x) { sum += 2 * x; });
+
+        signal.emit(3);
+        EXPECT_EQ(sum, 9);
+
+        signal(1);
+        EXPECT_EQ(sum, 12);
+    }
+
+    TEST(Signal_tests, Disconnect) {
+        int sum = 0;
+
+        Signal<void(int)> signal;
+        Connection a = signal.connect([&sum] (int x) { sum += x; });
+        Connection b = signal.connect([&sum] (int x) { sum += 10 * x; });
+
+        EXPECT_TRUE(signal.disconnect(a));
+        EXPECT_FALSE(signal.disconnect(a));
+        EXPECT_FALSE(signal.connected(a));
+        EXPECT_TRUE(signal.connected(b));
+
+        signal.emit(1);
+        EXPECT_EQ(sum, 10);
+    }
+
+    TEST(Signal_tests, Stale_handle_after_reuse) {
+        int sum = 0;
+
+        Signal<void()> signal;
+        Connection a = signal.connect([&sum] () { sum += 1; });
+        signal.disconnect(a);
+
+        Connection b = signal.connect([&sum] () { sum += 2; });
+        EXPECT_EQ(a.index, b.index);
+        EXPECT_NE(a.generation, b.generation);
+
+        EXPECT_FALSE(signal.disconnect(a));
+        signal.emit();
+        EXPECT_EQ(sum, 2);
+    }
+
+    TEST(Signal_tests, Default_handle_refers_to_no_slot) {
+        int sum = 0;
+
+        Signal<void()> signal;
+        signal.connect([&sum] () { sum += 1; });
+
+        EXPECT_FALSE(signal.connected(Connection{}));
+        EXPECT_FALSE(signal.disconnect(Connection{}));
+        EXPECT_EQ(signal.size(), 1u);
+
+        signal.emit();
+        EXPECT_EQ(sum, 1);
+    }
+
+    TEST(Signal_tests, Slots_span_chunks) {
+        using signal_type = Signal<void(int&)>;
+        constexpr std::size_t n = signal_type::base_chunk_size * 7 + 5;
+
+        signal_type signal;
+        std::vector<Connection> connections;
+        for (std::size_t i = 0; i < n; ++i) {
+            connections.push_back(signal.connect([] (int& count) { ++count; }));
+        }
+
+        int count = 0;
+        signal.emit(count);
+        EXPECT_EQ(count, static_cast<int>(n));
+
+        for (std::size_t i = 0; i < n; i += 2) {
+            signal.disconnect(connections[i]);
+        }
+
+        count = 0;
+        signal.emit(count);
+        EXPECT_EQ(count, static_cast<int>(n / 2));
+        EXPECT_EQ(signal.size(), n / 2);
+    }
+
+    TEST(Signal_tests, Large_and_non_trivial_slots) {
+        auto owner = std::make_shared<int>(0);
+        std::array<int, 32> values{};
+        values[31] = 4;
+
+        {
+            Signal<void(int&)> signal;
+            signal.connect([owner] (int& x) { x += ++*owner; });
+            Connection c = signal.connect([values] (int& x) { x += values[31]; });
+
+            int x = 0;
+            signal.emit(x);
+            EXPECT_EQ(x, 5);
+
+            signal.disconnect(c);
+            signal.emit(x);
+            EXPECT_EQ(x, 7);
+            EXPECT_EQ(owner.use_count(), 2);
+        }
+
+        EXPECT_EQ(owner.use_count(), 1);
+    }
+
+    TEST(Signal_tests, Storage_is_aligned) {
+        struct alignas(64) Aligned_slot {
+            std::byte payload[100];
+
+            void operator()(int& misaligned) const {
+                // Read back through volatile so the check isn't folded away on
+                // the strength of the declared alignment
+                volatile std::uintptr_t address = reinterpret_cast<std::uintptr_t>(this);
+                misaligned += (address % alignof(Aligned_slot) != 0);
+            }
+        };
+
+        std::pmr::monotonic_buffer_resource arena;
+        std::pmr::polymorphic_allocator<std::byte> allocator{&arena};
+
+        // Leave the arena's cursor misaligned
+        static_cast<void>(allocator.allocate(1));
+
+        AA_SBO_signal<std::pmr::polymorphic_allocator<std::byte>, 32, void(int&)> signal{allocator};
+        for (int i = 0; i < 4; ++i) {
+            static_cast<void>(allocator.allocate(1));
+            signal.connect(Aligned_slot{});
+        }
+
+        int misaligned = 0;
+        signal.emit(misaligned);
+        EXPECT_EQ(misaligned, 0);
+    }
+
+    TEST(Signal_tests, Throwing_slot_does_not_stall_reclamation) {
+        auto owner = std::make_shared<int>(0);
+
+        Signal<void()> signal;
+        signal.connect([] () { throw std::runtime_error{"slot"}; });
+        Connection c = signal.connect([owner] () {});
+        EXPECT_EQ(owner.use_count(), 2);
+
+        EXPECT_THROW(signal.emit(), std::runtime_error);
+
+        EXPECT_TRUE(signal.disconnect(c));
+        EXPECT_EQ(owner.use_count(), 1);
+
+        Connection d = signal.connect([] () {});
+        EXPECT_EQ(d.index, c.index);
+    }
+
+    TEST(Signal_tests, Disconnect_during_emission) {
+        Signal<void()> signal;
+
+        int calls = 0;
+        Connection self{};
+        self = signal.connect([&] () {
+            ++calls;
+            signal.disconnect(self);
+        });
+
+        signal.emit();
+        signal.emit();
+        EXPECT_EQ(calls, 1);
+
+        // Slot is reclaimed once no emission is in flight
+        signal.connect([] () {});
+        EXPECT_EQ(signal.size(), 1u);
+    }
+
+    TEST(Signal_tests, Concurrent_emission_and_modification) {
+        Signal<void(std::atomic<long>&)> signal;
+        std::atomic<bool> done{false};
+
+        std::vector<std::thread> emitters;
+        for (int t = 0; t < 3; ++t) {
+            emitters.emplace_back([&] () {
+                std::atomic<long> total{0};
+                while (!done.load()) {
+                    signal.emit(total);
+                }
+            });
+        }
+
+        std::array<long, 16> payload{};
+        payload[0] = 1;
+        for (int i = 0; i < 2000; ++i) {
+            Connection a = signal.connect([payload] (std::atomic<long>& total) { total += payload[0]; });
+            Connection b = signal.connect([] (std::atomic<long>& total) { total += 1; });
+            signal.disconnect(a);
+            if (i % 2) {
+                signal.disconnect(b);
+            }
+        }
+
+        done = true;
+        for (auto& t : emitters) {
+            t.join();
+        }
+
+        EXPECT_EQ(signal.size(), 1000u);
+    }
+
+}
+
+#endif
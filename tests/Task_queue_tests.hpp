@@ -0,0 +1,223 @@
+#ifndef ATUL_TASK_QUEUE_TESTS
+#define ATUL_TASK_QUEUE_TESTS
+
+#include <atul/Task_queue.hpp>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace atul::tests {
+
+    //=====================================================
+    // Task_queue tests
+    //=====================================================
+
+    TEST(Task_queue_tests, Capacity_is_rounded_up) {
+        Task_queue<void()> queue{100};
+        EXPECT_EQ(queue.capacity(), 128u);
+    }
+
+    TEST(Task_queue_tests, Empty_queue) {
+        Task_queue<void()> queue{4};
+        EXPECT_FALSE(queue.try_pop_invoke());
+    }
+
+    TEST(Task_queue_tests, First_in_first_out) {
+        std::vector<int> order;
+
+        Task_queue<void(int)> queue{8};
+        for (int i = 0; i < 5; ++i) {
+            EXPECT_TRUE(queue.try_push([&order, i] (int offset) { order.push_back(i + offset); }));
+        }
+
+        while (queue.try_pop_invoke(10)) {}
+
+        EXPECT_EQ(order, (std::vector<int>{10, 11, 12, 13, 14}));
+    }
+
+    TEST(Task_queue_tests, Full_queue_leaves_callable_untouched) {
+        Task_queue<void()> queue{2};
+        EXPECT_TRUE(queue.try_push([] () {}));
+        EXPECT_TRUE(queue.try_push([] () {}));
+
+        auto owner = std::make_shared<int>(0);
+        auto task = [owner] () { ++*owner; };
+        EXPECT_FALSE(queue.try_push(std::move(task)));
+        EXPECT_EQ(owner.use_count(), 2);
+
+        EXPECT_TRUE(queue.try_pop_invoke());
+        EXPECT_TRUE(queue.try_push(std::move(task)));
+    }
+
+    TEST(Task_queue_tests, Move_only_and_heap_tasks) {
+        int sum = 0;
+
+        Task_queue<void()> queue{4};
+        queue.try_push([&sum, p = std::make_unique<int>(3)] () { sum += *p; });
+
+        std::array<int, 64> values{};
+        values[63] = 4;
+        queue.try_push([&sum, values] () { sum += values[63]; });
+
+        Task_queue<void()>::function_type function{[&sum] () { sum += 5; }};
+        queue.try_push(std::move(function));
+
+        while (queue.try_pop_invoke()) {}
+        EXPECT_EQ(sum, 12);
+    }
+
+    TEST(Task_queue_tests, Pending_tasks_destroyed) {
+        auto owner = std::make_shared<int>(0);
+
+        {
+            Task_queue<void()> queue{4};
+            queue.try_push([owner] () {});
+            queue.try_push([owner] () {});
+            queue.try_pop_invoke();
+            EXPECT_EQ(owner.use_count(), 2);
+        }
+
+        EXPECT_EQ(owner.use_count(), 1);
+    }
+
+    struct Throwing_task {
+        Throwing_task() = default;
+
+        Throwing_task(const Throwing_task&) {
+            throw std::runtime_error{"copy"};
+        }
+
+        void operator()() {}
+    };
+
+    TEST(Task_queue_tests, Throwing_construction_is_skipped) {
+        int calls = 0;
+
+        Task_queue<void()> queue{4};
+        Throwing_task throwing{};
+        EXPECT_THROW(queue.try_push(throwing), std::runtime_error);
+        queue.try_push([&calls] () { ++calls; });
+
+        EXPECT_TRUE(queue.try_pop_invoke());
+        EXPECT_FALSE(queue.try_pop_invoke());
+        EXPECT_EQ(calls, 1);
+    }
+
+    TEST(Task_queue_tests, Inline_tasks_do_not_allocate) {
+        Counting_resource resource;
+        AA_SBO_task_queue<std::pmr::polymorphic_allocator<std::byte>, 48, void()> queue{16, &resource};
+        EXPECT_EQ(resource.allocations, 1u);
+
+        std::atomic<int> sum{0};
+        std::thread producer{[&] () {
+            for (int i = 0; i < 1000; ++i) {
+                while (!queue.try_push([&sum, i] () { sum += i; })) {
+                    std::this_thread::yield();
+                }
+            }
+        }};
+
+        for (int popped = 0; popped < 1000;) {
+            if (queue.try_pop_invoke()) {
+                ++popped;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+
+        EXPECT_EQ(sum.load(), 999 * 1000 / 2);
+        EXPECT_EQ(resource.allocations, 1u);
+    }
+
+    TEST(Task_queue_tests, Functions_are_moved_rather_than_wrapped) {
+        using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+        Counting_resource resource;
+        AA_SBO_task_queue<allocator_type, 48, void()> queue{16, &resource};
+        EXPECT_EQ(resource.allocations, 1u);
+
+        int sum = 0;
+        std::array<int, 4> values{1, 2, 3, 4};
+        AA_SBO_function<allocator_type, 48, void()> copyable{allocator_type{&resource}, [&sum, values] () {
+            for (int v : values) {
+                sum += v;
+            }
+        }};
+        AA_SBO_unique_function<allocator_type, 48, void()> unique{allocator_type{&resource}, [&sum] () { sum += 100; }};
+        EXPECT_EQ(resource.allocations, 1u);
+
+        EXPECT_TRUE(queue.try_push(std::move(copyable)));
+        EXPECT_TRUE(queue.try_push(std::move(unique)));
+        EXPECT_EQ(resource.allocations, 1u);
+
+        EXPECT_TRUE(queue.try_pop_invoke());
+        EXPECT_TRUE(queue.try_pop_invoke());
+        EXPECT_EQ(sum, 110);
+
+        static_assert(std::is_convertible_v<SBO_function<48, void()>, Task_queue<void()>::function_type>);
+        SBO_function<48, void()> function{[&sum, values] () { sum += values[3]; }};
+        Task_queue<void()> default_queue{4};
+        EXPECT_TRUE(default_queue.try_push(std::move(function)));
+        EXPECT_TRUE(default_queue.try_pop_invoke());
+        EXPECT_EQ(sum, 114);
+    }
+
+    TEST(Task_queue_tests, Concurrent_producers_and_consumers) {
+        constexpr int producer_count = 4;
+        constexpr int consumer_count = 4;
+        constexpr long tasks_per_producer = 20000;
+
+        Task_queue<void(std::atomic<long>&)> queue{64};
+        std::atomic<long> sum{0};
+        std::atomic<long> consumed{0};
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producer_count; ++p) {
+            threads.emplace_back([&queue, p] () {
+                for (long i = 0; i < tasks_per_producer; ++i) {
+                    if (i % 8 == 0) {
+                        std::array<long, 16> payload{};
+                        payload[15] = p + 1;
+                        while (!queue.try_push([payload] (std::atomic<long>& s) { s += payload[15]; })) {
+                            std::this_thread::yield();
+                        }
+                    } else {
+                        const long value = p + 1;
+                        while (!queue.try_push([value] (std::atomic<long>& s) { s += value; })) {
+                            std::this_thread::yield();
+                        }
+                    }
+                }
+            });
+        }
+
+        for (int c = 0; c < consumer_count; ++c) {
+            threads.emplace_back([&] () {
+                while (consumed.load() < producer_count * tasks_per_producer) {
+                    if (queue.try_pop_invoke(sum)) {
+                        ++consumed;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        EXPECT_EQ(consumed.load(), producer_count * tasks_per_producer);
+        EXPECT_EQ(sum.load(), (1 + 2 + 3 + 4) * tasks_per_producer);
+        EXPECT_FALSE(queue.try_pop_invoke(sum));
+    }
+
+}
+
+#endif
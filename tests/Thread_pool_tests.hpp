@@ -0,0 +1,244 @@
+#ifndef ATUL_THREAD_POOL_TESTS
+#define ATUL_THREAD_POOL_TESTS
+
+#include <atul/Thread_pool.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace atul::tests {
+
+    //=====================================================
+    // Work_stealing_deque tests
+    //=====================================================
+
+    TEST(Work_stealing_deque_tests, Take_is_last_in_first_out) {
+        Work_stealing_deque<int> deque;
+        deque.emplace(1);
+        deque.emplace(2);
+
+        alignas(int) std::byte storage[sizeof(int)];
+        ASSERT_TRUE(deque.take(storage));
+        EXPECT_EQ(*std::launder(reinterpret_cast<int*>(storage)), 2);
+        ASSERT_TRUE(deque.steal(storage));
+        EXPECT_EQ(*std::launder(reinterpret_cast<int*>(storage)), 1);
+        EXPECT_FALSE(deque.take(storage));
+        EXPECT_FALSE(deque.steal(storage));
+        EXPECT_TRUE(deque.empty());
+    }
+
+    TEST(Work_stealing_deque_tests, Growth_preserves_elements) {
+        Work_stealing_deque<long> deque;
+        const long n = Work_stealing_deque<long>::initial_capacity * 4 + 3;
+        for (long i = 0; i < n; ++i) {
+            deque.emplace(i);
+        }
+
+        alignas(long) std::byte storage[sizeof(long)];
+        for (long i = 0; i < n; ++i) {
+            ASSERT_TRUE(deque.steal(storage));
+            EXPECT_EQ(*std::launder(reinterpret_cast<long*>(storage)), i);
+        }
+    }
+
+    TEST(Work_stealing_deque_tests, Concurrent_thieves_take_each_element_once) {
+        constexpr long n = 20000;
+
+        Work_stealing_deque<long> deque;
+        std::atomic<long> sum{0};
+        std::atomic<long> count{0};
+        std::atomic<bool> done{false};
+
+        std::vector<std::thread> thieves;
+        for (int i = 0; i < 3; ++i) {
+            thieves.emplace_back([&] () {
+                alignas(long) std::byte storage[sizeof(long)];
+                while (!done.load() || !deque.empty()) {
+                    if (deque.steal(storage)) {
+                        sum += *std::launder(reinterpret_cast<long*>(storage));
+                        ++count;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        alignas(long) std::byte storage[sizeof(long)];
+        for (long i = 0; i < n; ++i) {
+            deque.emplace(i);
+            if (i % 3 == 0 && deque.take(storage)) {
+                sum += *std::launder(reinterpret_cast<long*>(storage));
+                ++count;
+            }
+        }
+        done = true;
+
+        for (auto& t : thieves) {
+            t.join();
+        }
+
+        EXPECT_EQ(count.load(), n);
+        EXPECT_EQ(sum.load(), n * (n - 1) / 2);
+    }
+
+    //=====================================================
+    // Thread_pool tests
+    //=====================================================
+
+    TEST(Thread_pool_tests, Submit_returns_result) {
+        Thread_pool pool{2};
+
+        Future<int> future = pool.submit([] () { return 42; });
+        EXPECT_EQ(future.get(), 42);
+        EXPECT_FALSE(future.valid());
+    }
+
+    TEST(Thread_pool_tests, Void_and_move_only_results) {
+        Thread_pool pool{2};
+
+        std::atomic<int> x{0};
+        Future<void> a = pool.submit([&x] () { x = 1; });
+        Future<std::unique_ptr<int>> b = pool.submit([p = std::make_unique<int>(5)] () mutable { return std::move(p); });
+
+        a.get();
+        EXPECT_EQ(x.load(), 1);
+        EXPECT_EQ(*b.get(), 5);
+    }
+
+    TEST(Thread_pool_tests, Reference_results) {
+        Thread_pool pool{2};
+
+        int x = 1;
+        Future<int&> future = pool.submit([&x] () -> int& { return x; });
+
+        int& result = future.get();
+        EXPECT_EQ(&result, &x);
+    }
+
+    TEST(Thread_pool_tests, Futures_outlive_pool) {
+        Future<int> value;
+        Future<void> failure;
+
+        {
+            Thread_pool pool{1};
+            value = pool.submit([] () {
+                std::this_thread::sleep_for(std::chrono::milliseconds{10});
+                return 7;
+            });
+            failure = pool.submit([] () { throw std::runtime_error{"task"}; });
+        }
+
+        value.wait();
+        EXPECT_EQ(value.get(), 7);
+        EXPECT_THROW(failure.get(), std::runtime_error);
+    }
+
+    TEST(Thread_pool_tests, Exceptions_propagate) {
+        Thread_pool pool{1};
+
+        Future<int> future = pool.submit([] () -> int { throw std::runtime_error{"task"}; });
+        EXPECT_THROW(future.get(), std::runtime_error);
+    }
+
+    TEST(Thread_pool_tests, Discarded_futures) {
+        std::atomic<int> count{0};
+
+        {
+            Thread_pool pool{2};
+            for (int i = 0; i < 1000; ++i) {
+                static_cast<void>(pool.submit([&count] () { ++count; }));
+            }
+        }
+
+        EXPECT_EQ(count.load(), 1000);
+    }
+
+    TEST(Thread_pool_tests, Large_tasks) {
+        Thread_pool pool{2};
+
+        std::array<long, 32> values{};
+        values[31] = 7;
+        Future<long> future = pool.submit([values] () { return values[31]; });
+        EXPECT_EQ(future.get(), 7);
+    }
+
+    long parallel_sum(Thread_pool& pool, long first, long last) {
+        if (last - first <= 64) {
+            long sum = 0;
+            for (long i = first; i < last; ++i) {
+                sum += i;
+            }
+            return sum;
+        }
+
+        const long middle = first + (last - first) / 2;
+        Future<long> left = pool.submit([&pool, first, middle] () { return parallel_sum(pool, first, middle); });
+        const long right = parallel_sum(pool, middle, last);
+        return left.get() + right;
+    }
+
+    TEST(Thread_pool_tests, Nested_submission_from_workers) {
+        Thread_pool pool{4};
+
+        const long n = 100000;
+        Future<long> future = pool.submit([&pool] () { return parallel_sum(pool, 0, n); });
+        EXPECT_EQ(future.get(), n * (n - 1) / 2);
+    }
+
+    TEST(Thread_pool_tests, Tasks_which_are_not_trivially_relocatable) {
+        Thread_pool pool{2};
+
+        Future<std::size_t> future = pool.submit([&pool] () {
+            std::vector<Future<std::size_t>> futures;
+            for (int i = 0; i < 100; ++i) {
+                futures.push_back(pool.submit([text = std::string(static_cast<std::size_t>(i % 20), 'x')] () {
+                    return text.size();
+                }));
+            }
+
+            std::size_t total = 0;
+            for (Future<std::size_t>& f : futures) {
+                total += f.get();
+            }
+            return total;
+        });
+
+        EXPECT_EQ(future.get(), 5u * (0 + 19) * 20 / 2);
+    }
+
+    TEST(Thread_pool_tests, Many_external_submitters) {
+        Thread_pool pool{3};
+        std::atomic<long> sum{0};
+
+        std::vector<std::thread> submitters;
+        for (int t = 0; t < 4; ++t) {
+            submitters.emplace_back([&pool, &sum] () {
+                std::vector<Future<void>> futures;
+                for (int i = 0; i < 5000; ++i) {
+                    futures.push_back(pool.submit([&sum, i] () { sum += i; }));
+                }
+
+                for (auto& future : futures) {
+                    future.wait();
+                }
+            });
+        }
+
+        for (auto& t : submitters) {
+            t.join();
+        }
+
+        EXPECT_EQ(sum.load(), 4L * (4999L * 5000L / 2));
+    }
+
+}
+
+#endif
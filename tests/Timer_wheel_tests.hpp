@@ -0,0 +1,213 @@
+#ifndef ATUL_TIMER_WHEEL_TESTS
+#define ATUL_TIMER_WHEEL_TESTS
+
+#include <atul/Timer_wheel.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace atul::tests {
+
+    //=====================================================
+    // Timer_wheel tests
+    //=====================================================
+
+    TEST(Timer_wheel_tests, Fires_at_deadline) {
+        Timer_wheel wheel;
+        int calls = 0;
+        wheel.schedule(5, [&calls] () { ++calls; });
+
+        EXPECT_EQ(wheel.advance(4), 0u);
+        EXPECT_EQ(calls, 0);
+        EXPECT_EQ(wheel.advance(5), 1u);
+        EXPECT_EQ(calls, 1);
+        EXPECT_TRUE(wheel.empty());
+        EXPECT_EQ(wheel.now(), 5u);
+    }
+
+    TEST(Timer_wheel_tests, Past_deadline_fires_on_next_tick) {
+        Timer_wheel wheel{100};
+        int calls = 0;
+        wheel.schedule(50, [&calls] () { ++calls; });
+
+        EXPECT_EQ(wheel.next_event(), 101u);
+        wheel.advance(100);
+        EXPECT_EQ(calls, 0);
+        wheel.advance(101);
+        EXPECT_EQ(calls, 1);
+    }
+
+    TEST(Timer_wheel_tests, Same_deadline_fires_in_scheduling_order) {
+        Timer_wheel wheel;
+        std::vector<int> order;
+        for (int i = 0; i < 5; ++i) {
+            wheel.schedule(1000, [&order, i] () { order.push_back(i); });
+        }
+
+        wheel.advance(1000);
+        EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3, 4}));
+    }
+
+    TEST(Timer_wheel_tests, Cascading_fires_exactly_at_deadline) {
+        Timer_wheel wheel{7};
+        std::mt19937_64 engine{42};
+
+        std::vector<std::uint64_t> deadlines;
+        for (int i = 0; i < 2000; ++i) {
+            const int magnitude = i % 40;
+            deadlines.push_back(8 + engine() % (std::uint64_t{1} << magnitude));
+        }
+        deadlines.push_back(std::uint64_t{1} << 62);
+
+        std::size_t mismatches = 0;
+        for (std::uint64_t deadline : deadlines) {
+            wheel.schedule(deadline, [&wheel, &mismatches, deadline] () {
+                mismatches += wheel.now() != deadline;
+            });
+        }
+
+        std::size_t fired = 0;
+        std::uint64_t now = 7;
+        while (now < (std::uint64_t{1} << 41)) {
+            now += 1 + engine() % (std::uint64_t{1} << (engine() % 42));
+            fired += wheel.advance(now);
+        }
+        fired += wheel.advance(std::uint64_t{1} << 63);
+
+        EXPECT_EQ(fired, deadlines.size());
+        EXPECT_EQ(mismatches, 0u);
+    }
+
+    TEST(Timer_wheel_tests, Cancel) {
+        Timer_wheel wheel;
+        int calls = 0;
+        Timer_id a = wheel.schedule(10, [&calls] () { calls += 1; });
+        Timer_id b = wheel.schedule(5000, [&calls] () { calls += 10; });
+
+        EXPECT_TRUE(wheel.pending(b));
+        EXPECT_TRUE(wheel.cancel(b));
+        EXPECT_FALSE(wheel.pending(b));
+        EXPECT_FALSE(wheel.cancel(b));
+        EXPECT_EQ(wheel.size(), 1u);
+
+        wheel.advance(10000);
+        EXPECT_EQ(calls, 1);
+        EXPECT_FALSE(wheel.cancel(a));
+
+        // Reused entries are not reachable through stale handles
+        Timer_id c = wheel.schedule(20000, [] () {});
+        EXPECT_EQ(c.index, a.index);
+        EXPECT_FALSE(wheel.pending(a));
+        EXPECT_TRUE(wheel.pending(c));
+    }
+
+    TEST(Timer_wheel_tests, Default_handle_refers_to_no_timer) {
+        Timer_wheel wheel;
+        int calls = 0;
+        wheel.schedule(10, [&calls] () { ++calls; });
+
+        EXPECT_FALSE(wheel.pending(Timer_id{}));
+        EXPECT_FALSE(wheel.cancel(Timer_id{}));
+        EXPECT_EQ(wheel.size(), 1u);
+
+        wheel.advance(10);
+        EXPECT_EQ(calls, 1);
+    }
+
+    TEST(Timer_wheel_tests, Throwing_callback_does_not_strand_timers) {
+        Timer_wheel wheel;
+        std::vector<int> order;
+
+        wheel.schedule(10, [&order] () { order.push_back(1); });
+        wheel.schedule(10, [] () { throw std::runtime_error{"first"}; });
+        wheel.schedule(10, [&order] () { order.push_back(2); });
+        wheel.schedule(10, [] () { throw std::logic_error{"second"}; });
+        wheel.schedule(20, [&order] () { order.push_back(3); });
+
+        EXPECT_THROW(wheel.advance(100), std::runtime_error);
+        EXPECT_EQ(order, (std::vector<int>{1, 2}));
+        EXPECT_EQ(wheel.size(), 1u);
+        EXPECT_EQ(wheel.next_event(), 20u);
+
+        EXPECT_EQ(wheel.advance(100), 1u);
+        EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+        EXPECT_TRUE(wheel.empty());
+    }
+
+    TEST(Timer_wheel_tests, Callbacks_schedule_and_cancel) {
+        Timer_wheel wheel;
+        int periodic_calls = 0;
+        int cancelled_calls = 0;
+
+        Timer_id cancelled = wheel.schedule(3, [&cancelled_calls] () { ++cancelled_calls; });
+
+        struct Periodic {
+            Timer_wheel* wheel;
+            int* calls;
+
+            void operator()() const {
+                if (++*calls < 10) {
+                    wheel->schedule(wheel->now() + 1, *this);
+                }
+            }
+        };
+
+        wheel.schedule(1, [&wheel, cancelled] () { wheel.cancel(cancelled); });
+        wheel.schedule(1, Periodic{&wheel, &periodic_calls});
+
+        wheel.advance(100);
+        EXPECT_EQ(periodic_calls, 10);
+        EXPECT_EQ(cancelled_calls, 0);
+    }
+
+    TEST(Timer_wheel_tests, Clear_destroys_callbacks) {
+        auto counter = std::make_shared<int>(0);
+        {
+            Timer_wheel wheel;
+            for (int i = 0; i < 100; ++i) {
+                wheel.schedule(i * 1000, [counter] () { ++*counter; });
+            }
+
+            EXPECT_EQ(counter.use_count(), 101);
+            wheel.clear();
+            EXPECT_EQ(counter.use_count(), 1);
+
+            wheel.schedule(1, [counter] () { ++*counter; });
+        }
+
+        EXPECT_EQ(counter.use_count(), 1);
+        EXPECT_EQ(*counter, 0);
+    }
+
+    TEST(Timer_wheel_tests, Entries_come_from_slabs) {
+        Counting_resource resource;
+        {
+            AA_SBO_timer_wheel<std::pmr::polymorphic_allocator<std::byte>, 32> wheel{0, &resource};
+
+            std::array<long, 3> capture{1, 2, 3};
+            long sum = 0;
+            for (int round = 0; round < 4; ++round) {
+                for (int i = 0; i < 1000; ++i) {
+                    wheel.schedule(wheel.now() + 1 + i, [&sum, capture] () { sum += capture[0]; });
+                }
+                wheel.advance(wheel.now() + 1000);
+            }
+
+            EXPECT_EQ(sum, 4000);
+
+            // Four slabs plus the growth of the list of slabs
+            EXPECT_LE(resource.allocations, 8u);
+        }
+
+        EXPECT_EQ(resource.deallocations, resource.allocations);
+    }
+
+}
+
+#endif